@@ -7,11 +7,6 @@ int main()
 {
 	rapidcsv::Document doc("data.csv", rapidcsv::LabelParams(-1, -1), rapidcsv::SeparatorParams(';'));
 
-	vector<pair<string, string>> data;
-
-	for (size_t i = 0; i < doc.GetRowCount(); i++)
-		data.push_back({ doc.GetCell<string>(0, i), doc.GetCell<string>(1, i) });
-
 	Mat image;
 
 	Scalar redColor(0, 0, 255);
@@ -33,7 +28,7 @@ int main()
 	params.Font = FONT_HERSHEY_SIMPLEX;
 
 	IDFlowMaker maker(params);
-	maker.createFlow(image, data, "All Orders", 3.5);
+	maker.createFlow(image, doc, 0, 1, "All Orders", 0);
 
 	imshow("kurs02", image);
 	waitKey();
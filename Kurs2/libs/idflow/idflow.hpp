@@ -26,8 +26,35 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+
 #include <opencv2/opencv.hpp>
 
+#if defined(IDFLOW_HAVE_LIBPNG)
+#include <png.h>
+#endif
+
 using namespace std;
 using namespace cv;
 
@@ -93,6 +120,10 @@ namespace idflow {
 		 * @param pTextOffset Distance between edges of rectangles and their inner text labels
 		 * @param pFontSize Font size of all text labels
 		 * @param pFont Font (from cv::HersheyFonts enum) of all text labels
+		 * @param pThreads Number of worker threads used to aggregate data sources and to draw images in horizontal bands. 0 means the number of threads used by OpenCV, 1 disables parallel processing
+		 * @param pMaxGroups Maximum number of rectangles on each side besides the ones present in the order list. The largest groups are kept and the rest
+		 *		  are merged into one group labeled OtherLabel. 0 means no limit
+		 * @param pOtherLabel A string that is used as a label of the group merging the groups exceeding MaxGroups
 		 */
 		explicit IDFlowParams(const int pImageWidth = 0,
 			const int pImageHeight = 0,
@@ -106,7 +137,10 @@ namespace idflow {
 			const int pPadding = 20,
 			const int pTextOffset = 3,
 			const double pFontSize = 0.4,
-			const HersheyFonts pFont = FONT_HERSHEY_SIMPLEX) {
+			const HersheyFonts pFont = FONT_HERSHEY_SIMPLEX,
+			const int pThreads = 1,
+			const int pMaxGroups = 0,
+			const string pOtherLabel = "Other") {
 
 			ImageWidth = pImageWidth;
 			ImageHeight = pImageHeight;
@@ -121,6 +155,9 @@ namespace idflow {
 			TextOffset = pTextOffset;
 			FontSize = pFontSize;
 			Font = pFont;
+			Threads = pThreads;
+			MaxGroups = pMaxGroups;
+			OtherLabel = pOtherLabel;
 		}
 #if defined(_MSC_VER)
 #pragma warning (pop)
@@ -280,6 +317,48 @@ namespace idflow {
 		 * @return Font value
 		 */
 		HersheyFonts getFont() { return mFont; }
+		/**
+		 * @brief Threads property setter
+		 * @param pThreads New non-negative value
+		 */
+		void putThreads(int pThreads) {
+			if (pThreads < 0)
+				throw invalid_argument("Threads must be greater than or equal to 0");
+			mThreads = pThreads;
+		}
+		/**
+		 * @brief Threads property getter
+		 * @return Threads value
+		 */
+		int getThreads() { return mThreads; }
+		/**
+		 * @brief MaxGroups property setter
+		 * @param pMaxGroups New non-negative value
+		 */
+		void putMaxGroups(int pMaxGroups) {
+			if (pMaxGroups < 0)
+				throw invalid_argument("Max groups must be greater than or equal to 0");
+			mMaxGroups = pMaxGroups;
+		}
+		/**
+		 * @brief MaxGroups property getter
+		 * @return MaxGroups value
+		 */
+		int getMaxGroups() { return mMaxGroups; }
+		/**
+		 * @brief OtherLabel property setter
+		 * @param pOtherLabel New non-empty value
+		 */
+		void putOtherLabel(string pOtherLabel) {
+			if (pOtherLabel.empty())
+				throw length_error("Other label can not be empty");
+			mOtherLabel = pOtherLabel;
+		}
+		/**
+		 * @brief OtherLabel property getter
+		 * @return OtherLabel value
+		 */
+		string getOtherLabel() { return mOtherLabel; }
 		/**
 		 * @brief Total width (in pixels) or resulting matrix (image). If the value provided is less than or equal to 0, resulting width will be calculated automatically
 		 */
@@ -334,6 +413,19 @@ namespace idflow {
 		 * @brief Font (from cv::HersheyFonts enum) of all text labels
 		 */
 		__declspec(property(get = getFont, put = putFont)) HersheyFonts Font;
+		/**
+		 * @brief Number of worker threads used to aggregate data sources. 0 means the number of threads used by OpenCV, 1 disables parallel processing
+		 */
+		__declspec(property(get = getThreads, put = putThreads)) int Threads;
+		/**
+		 * @brief Maximum number of rectangles on each side besides the ones present in the order list. The largest groups are kept and the rest
+		 *		  are merged into one group labeled OtherLabel. 0 means no limit
+		 */
+		__declspec(property(get = getMaxGroups, put = putMaxGroups)) int MaxGroups;
+		/**
+		 * @brief A string that is used as a label of the group merging the groups exceeding MaxGroups
+		 */
+		__declspec(property(get = getOtherLabel, put = putOtherLabel)) string OtherLabel;
 
 	private:
 
@@ -350,235 +442,3343 @@ namespace idflow {
 		int mTextOffset;
 		double mFontSize;
 		HersheyFonts mFont;
+		int mThreads;
+		int mMaxGroups;
+		string mOtherLabel;
 	};
 
 	/**
-	 * @brief Inter-dimensional flow maker
+	 * @brief Binary encoding of aggregated data snapshots: a header of 4 magic bytes and a format version,
+	 *		  variable-length integers (7 bits per byte, least significant first) and length-prefixed strings
 	 */
-	class IDFlowMaker {
+	class IDFlowSnapshot {
 	public:
 		/**
-		 * @brief IDFlowMaker instance constructor
-		 * @param pParams Instance of IDFlowParams class used to create inter-dimensional flows
+		 * @brief Version of the snapshot format
 		 */
-		explicit IDFlowMaker(const IDFlowParams& pParams) : mParams(pParams) {}
+		static const char VERSION = 2;
 
 		/**
-		 * @brief Create an inter-dimensional flow based on provided to this function parameters and the data from the IDFlowParams class
-		 * @param image Output matrix (image) containing the inter-dimensional flow
-		 * @param data A vector of pairs of strings which is used as a source of data
-		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
-		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow
+		 * @brief Write a snapshot header
+		 * @param stream Output binary stream
+		 * @param magic 4 bytes identifying the type of the snapshot
 		 */
-		void createFlow(
-			Mat& image,
-			const vector<pair<string, string>> data,
-			const string totalLabel,
-			const double countPerPixel) {
+		static void writeHeader(ostream& stream, const char* magic) {
+			stream.write(magic, 4);
+			stream.put(VERSION);
+		}
 
-			if (data.size() == 0)
-				throw length_error("Data can not be empty");
-			if (totalLabel.empty())
-				throw length_error("Total label can not be empty");
-			if (countPerPixel <= 0)
-				throw invalid_argument("Count per pixel must be greater than 0");
+		/**
+		 * @brief Read and check a snapshot header
+		 * @param stream Input binary stream
+		 * @param magic 4 bytes identifying the expected type of the snapshot
+		 */
+		static void readHeader(istream& stream, const char* magic) {
+			char header[5];
+			read(stream, header, sizeof(header));
+			if (memcmp(header, magic, 4) != 0 || header[4] != VERSION)
+				throw invalid_argument("Unsupported snapshot format");
+		}
 
-			vector<string> ins;
-			vector<string> outs;
+		/**
+		 * @brief Write a non-negative integer
+		 * @param stream Output binary stream
+		 * @param value Value to write
+		 */
+		static void writeUnsigned(ostream& stream, uint64_t value) {
+			while (value >= 0x80) {
+				stream.put(static_cast<char>((value & 0x7f) | 0x80));
+				value >>= 7;
+			}
+			stream.put(static_cast<char>(value));
+		}
 
-			for (const pair p : data)
-				ins.push_back(p.first);
-			for (const pair p : data)
-				outs.push_back(p.second);
+		/**
+		 * @brief Read a non-negative integer
+		 * @param stream Input binary stream
+		 * @return Value read
+		 */
+		static uint64_t readUnsigned(istream& stream) {
+			uint64_t value = 0;
+			for (int shift = 0; shift < 64; shift += 7) {
+				char byte;
+				read(stream, &byte, 1);
+				value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+					return value;
+			}
+			throw invalid_argument("Invalid integer in snapshot");
+		}
 
-			const Scalar rectangleColor = mParams.FigureColor;
+		/**
+		 * @brief Write a count or a weight. Integral values are written as variable-length integers, other values as 8 bytes. Both are read back
+		 *		  exactly, but only integral counts sum to the same value whatever the order snapshots are merged in
+		 * @param stream Output binary stream
+		 * @param value Value to write
+		 */
+		static void writeNumber(ostream& stream, const double value) {
+			if (value == floor(value) && abs(value) <= MAXIMUM_EXACT_INTEGER) {
+				const int64_t integer = static_cast<int64_t>(value);
+				writeUnsigned(stream, ((static_cast<uint64_t>(integer) << 1) ^ static_cast<uint64_t>(integer >> 63)) << 1);
+				return;
+			}
 
-			vector<IDFlowGroup> inGroups;
-			vector<IDFlowGroup> outGroups;
-			countValuesAndReorder(inGroups, ins, mParams.InGroups, rectangleColor);
-			countValuesAndReorder(outGroups, outs, mParams.OutGroups, rectangleColor);
+			uint64_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			writeUnsigned(stream, 1);
+			for (int i = 0; i < 8; i++)
+				stream.put(static_cast<char>(bits >> (8 * i)));
+		}
 
-			map<Scalar, int, ScalarCompare> inColorToTotalCount;
-			map<Scalar, int, ScalarCompare> outColorToTotalCount;
+		/**
+		 * @brief Read a count or a weight
+		 * @param stream Input binary stream
+		 * @return Value read
+		 */
+		static double readNumber(istream& stream) {
+			const uint64_t tag = readUnsigned(stream);
+			if ((tag & 1) == 0) {
+				const uint64_t encoded = tag >> 1;
+				return static_cast<double>(static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1));
+			}
+			if (tag != 1)
+				throw invalid_argument("Invalid number in snapshot");
 
-			for (const IDFlowGroup value : inGroups)
-				inColorToTotalCount[value.Color] += value.Count;
-			for (const IDFlowGroup value : outGroups)
-				outColorToTotalCount[value.Color] += value.Count;
+			char bytes[8];
+			read(stream, bytes, sizeof(bytes));
+			uint64_t bits = 0;
+			for (int i = 0; i < 8; i++)
+				bits |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
 
-			int imgWidth = mParams.ImageWidth;
-			int imgHeight = mParams.ImageHeight;
+			double value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
 
-			if (imgWidth <= 0)
-				imgWidth = 3 * mParams.FigureWidth + 2 * mParams.HorizontalSpacing + 2 * mParams.Padding;
+		/**
+		 * @brief Write a string
+		 * @param stream Output binary stream
+		 * @param value Value to write
+		 */
+		static void writeString(ostream& stream, const string_view value) {
+			writeUnsigned(stream, value.size());
+			stream.write(value.data(), value.size());
+		}
 
-			if (imgHeight <= 0) {
-				const auto& list = inGroups.size() >= outGroups.size() ? inGroups : outGroups;
-				imgHeight = (list.size() - 1) * mParams.VerticalSpacing + 2 * mParams.Padding;
-				for (const auto& p : list)
-					imgHeight += p.Count / countPerPixel;
+		/**
+		 * @brief Read a string
+		 * @param stream Input binary stream
+		 * @return Value read
+		 */
+		static string readString(istream& stream) {
+			string value;
+			char buffer[4096];
+			for (uint64_t size = readUnsigned(stream); size > 0;) {
+				const size_t chunk = static_cast<size_t>(min<uint64_t>(size, sizeof(buffer)));
+				read(stream, buffer, chunk);
+				value.append(buffer, chunk);
+				size -= chunk;
 			}
+			return value;
+		}
 
-			image = Mat(imgHeight, imgWidth, IMAGE_TYPE, mParams.BgColor);
+		/**
+		 * @brief Read an id and check that it is less than the number of ids
+		 * @param stream Input binary stream
+		 * @param size Number of ids
+		 * @return Id read
+		 */
+		static size_t readId(istream& stream, const size_t size) {
+			const uint64_t id = readUnsigned(stream);
+			if (id >= size)
+				throw invalid_argument("Invalid id in snapshot");
+			return static_cast<size_t>(id);
+		}
 
-			int verticalRectangleOffset = mParams.Padding;
-			int horizontalOffset = mParams.Padding;
-			int verticalCurveOffset = mParams.Padding;
+	private:
+		static constexpr double MAXIMUM_EXACT_INTEGER = 9007199254740992.0;
 
-			const int totalHeight = max(static_cast<int>(data.size() / countPerPixel), MINIMUM_FIGURE_HEIGHT);
+		static void read(istream& stream, char* data, const size_t size) {
+			if (!stream.read(data, size))
+				throw invalid_argument("Unexpected end of snapshot");
+		}
+	};
 
-			for (size_t i = 0, size = inGroups.size(); i < size; i++) {
-				const auto p = inGroups[i];
-				const int initialHeight = p.Count / countPerPixel;
-				const int height = max(initialHeight, MINIMUM_FIGURE_HEIGHT);
-				const int curveEndHeight = i == size - 1 ? (totalHeight + mParams.Padding - verticalCurveOffset) : initialHeight;
-				const Scalar recColor = applyAlpha(p.Color, mParams.BgColor, getAlpha(p.Count, inColorToTotalCount[p.Color]));
+	/**
+	 * @brief Distinct values of one dimension of inter-dimensional flow and their counts, kept in order of first appearance
+	 */
+	class IDFlowDimension {
+	public:
+		/**
+		 * @brief Count occurrences of a value
+		 * @param name Value from the data source
+		 * @param count Number of occurrences or weight to add
+		 * @return Dense id of the value, i.e. its position in order of first appearance
+		 */
+		size_t add(const string_view name, const double count = 1) {
+			auto it = mIds.find(name);
+			if (it == mIds.end()) {
+				it = mIds.emplace(string(name), mNames.size()).first;
+				mNames.emplace_back(name);
+				mCounts.push_back(0);
+			}
+			mCounts[it->second] += count;
+			return it->second;
+		}
 
-				drawRectangle(image, horizontalOffset, verticalRectangleOffset, mParams.FigureWidth, height, recColor, p.Name, to_string(p.Count), mParams.FontSize, mParams.Font, mParams.TextOffset);
-				drawFilledCurve(image, Point2d(horizontalOffset + mParams.FigureWidth, verticalRectangleOffset), Point2d(horizontalOffset + mParams.FigureWidth + mParams.HorizontalSpacing, verticalCurveOffset), height, curveEndHeight, recColor, rectangleColor);
+		/**
+		 * @brief Count weighted occurrences of many values at once. Values are resolved to dense ids first, then the weights are summed per id.
+		 *		  When there are several rows per distinct value, four interleaved partial sums are used so that consecutive rows of the same value
+		 *		  do not wait for each other's updates
+		 * @param names Values from the data source
+		 * @param weights Weights of the values, one per value
+		 */
+		template<typename TWeight>
+		void add(const span<const string_view> names, const span<const TWeight> weights) {
+			if (names.size() != weights.size())
+				throw invalid_argument("Weights must have one value per name");
 
-				verticalRectangleOffset += height + mParams.VerticalSpacing;
-				verticalCurveOffset += curveEndHeight;
-			}
+			vector<size_t> ids(names.size());
+			for (size_t i = 0, size = ids.size(); i < size; i++)
+				ids[i] = add(names[i], 0);
 
-			verticalRectangleOffset = mParams.Padding;
-			horizontalOffset += mParams.FigureWidth + mParams.HorizontalSpacing;
+			const size_t size = mCounts.size();
+			const size_t count = ids.size();
+			size_t i = 0;
+			if (3 * size <= count) {
+				vector<double> partials(3 * size, 0);
+				for (; i + 4 <= count; i += 4) {
+					mCounts[ids[i]] += weights[i];
+					partials[ids[i + 1]] += weights[i + 1];
+					partials[size + ids[i + 2]] += weights[i + 2];
+					partials[2 * size + ids[i + 3]] += weights[i + 3];
+				}
+				for (size_t id = 0; id < size; id++)
+					mCounts[id] += partials[id] + partials[size + id] + partials[2 * size + id];
+			}
+			for (; i < count; i++)
+				mCounts[ids[i]] += weights[i];
+		}
 
-			drawRectangle(image, horizontalOffset, verticalRectangleOffset, mParams.FigureWidth, totalHeight, rectangleColor, totalLabel, to_string(data.size()), mParams.FontSize, mParams.Font, mParams.TextOffset);
+		/**
+		 * @brief Add all values of another dimension. Values not seen before are appended in their order of first appearance in the other dimension
+		 * @param other Dimension to add
+		 */
+		void append(const IDFlowDimension& other) {
+			for (size_t i = 0, size = other.mNames.size(); i < size; i++)
+				add(other.mNames[i], other.mCounts[i]);
+		}
 
-			verticalRectangleOffset = mParams.Padding;
-			horizontalOffset += mParams.FigureWidth + mParams.HorizontalSpacing;
-			verticalCurveOffset = mParams.Padding;
+		/**
+		 * @brief Find the dense id of a value
+		 * @param name Value to look for
+		 * @return Dense id of the value or -1 if the value has not been counted
+		 */
+		ptrdiff_t find(const string_view name) const {
+			const auto it = mIds.find(name);
+			return it == mIds.end() ? -1 : static_cast<ptrdiff_t>(it->second);
+		}
 
-			for (size_t i = 0, size = outGroups.size(); i < size; i++) {
-				const auto p = outGroups[i];
-				const int initialHeight = p.Count / countPerPixel;
-				const int height = max(initialHeight, MINIMUM_FIGURE_HEIGHT);
-				const int curveEndHeight = i == size - 1 ? (totalHeight + mParams.Padding - verticalCurveOffset) : initialHeight;
-				const Scalar recColor = applyAlpha(p.Color, mParams.BgColor, getAlpha(p.Count, outColorToTotalCount[p.Color]));
+		/**
+		 * @brief Reorder values by name, e.g. to make merged data independent of the order of merging
+		 * @return New dense ids, indexed by old dense ids
+		 */
+		vector<size_t> sortByName() {
+			vector<size_t> ids(mNames.size());
+			for (size_t i = 0, size = ids.size(); i < size; i++)
+				ids[i] = i;
+			sort(ids.begin(), ids.end(), [this](size_t a, size_t b) { return mNames[a] < mNames[b]; });
 
-				drawRectangle(image, horizontalOffset, verticalRectangleOffset, mParams.FigureWidth, height, recColor, p.Name, to_string(p.Count), mParams.FontSize, mParams.Font, mParams.TextOffset);
-				drawFilledCurve(image, Point2d(horizontalOffset, verticalRectangleOffset), Point2d(horizontalOffset - mParams.HorizontalSpacing, verticalCurveOffset), height, curveEndHeight, recColor, rectangleColor);
+			IDFlowDimension sorted;
+			vector<size_t> newIds(ids.size());
+			for (size_t i = 0, size = ids.size(); i < size; i++) {
+				newIds[ids[i]] = i;
+				sorted.add(mNames[ids[i]], mCounts[ids[i]]);
+			}
+			*this = std::move(sorted);
+			return newIds;
+		}
 
-				verticalRectangleOffset += height + mParams.VerticalSpacing;
-				verticalCurveOffset += curveEndHeight;
+		/**
+		 * @brief Write values and their counts to a binary snapshot
+		 * @param stream Output binary stream
+		 */
+		void serialize(ostream& stream) const {
+			IDFlowSnapshot::writeUnsigned(stream, mNames.size());
+			for (size_t i = 0, size = mNames.size(); i < size; i++) {
+				IDFlowSnapshot::writeString(stream, mNames[i]);
+				IDFlowSnapshot::writeNumber(stream, mCounts[i]);
 			}
 		}
 
-	private:
-		static const int IMAGE_TYPE = CV_8UC3;
-		static const int MINIMUM_FIGURE_HEIGHT = 20;
-		static constexpr double MINIMUM_ALPHA = 0.25;
+		/**
+		 * @brief Read values and their counts from a binary snapshot
+		 * @param stream Input binary stream
+		 * @return Values and their counts
+		 */
+		static IDFlowDimension deserialize(istream& stream) {
+			IDFlowDimension result;
+			for (uint64_t i = 0, size = IDFlowSnapshot::readUnsigned(stream); i < size; i++) {
+				const string name = IDFlowSnapshot::readString(stream);
+				if (result.find(name) >= 0)
+					throw invalid_argument("Duplicate value in snapshot");
+				result.add(name, IDFlowSnapshot::readNumber(stream));
+			}
+			return result;
+		}
 
-		IDFlowParams mParams;
+		/**
+		 * @brief Number of distinct values
+		 * @return Number of distinct values
+		 */
+		size_t size() const { return mNames.size(); }
+		/**
+		 * @brief Names property getter
+		 * @return Distinct values in order of first appearance
+		 */
+		const vector<string>& getNames() const { return mNames; }
+		/**
+		 * @brief Counts property getter
+		 * @return Counts (sums of weights) of distinct values, indexed by dense id
+		 */
+		const vector<double>& getCounts() const { return mCounts; }
+		/**
+		 * @brief Distinct values in order of first appearance
+		 */
+		__declspec(property(get = getNames)) const vector<string>& Names;
+		/**
+		 * @brief Counts (sums of weights) of distinct values, indexed by dense id
+		 */
+		__declspec(property(get = getCounts)) const vector<double>& Counts;
 
-		class IDFlowGroup {
-		public:
-			string Name;
-			int Count;
-			Scalar Color;
-			explicit IDFlowGroup(string name, int count, Scalar color) {
-				Name = name;
-				Count = count;
-				Color = color;
-			}
+	private:
+		struct StringHash {
+			using is_transparent = void;
+			size_t operator() (const string_view value) const { return hash<string_view>{}(value); }
 		};
 
-		struct ScalarCompare {
-			bool operator() (const Scalar& lhs, const Scalar& rhs) const {
-				return (lhs[0] + lhs[1] * 256 + lhs[2] * 256 * 256) < (rhs[0] + rhs[1] * 256 + rhs[2] * 256 * 256);
-			}
-		};
+		vector<string> mNames;
+		vector<double> mCounts;
+		unordered_map<string, size_t, StringHash, equal_to<>> mIds;
+	};
 
-		static void drawRectangle(Mat& image, const int x, const int y, const int width, const int height, const Scalar bgColor, const string topLeftText, const string bottomRightText, const double fontSize, const int font, const int offset) {
-			Mat rect(height, width, IMAGE_TYPE);
-			rectangle(rect, Rect(0, 0, image.cols, image.rows), bgColor, FILLED);
+	/**
+	 * @brief Aggregated data of inter-dimensional flow: counts of the values on the left (in) and right (out) sides
+	 */
+	class IDFlowAggregate {
+	public:
+		/**
+		 * @brief IDFlowAggregate instance constructor for empty data
+		 */
+		IDFlowAggregate() = default;
 
-			Scalar textColor = getContrastColor(bgColor);
+		/**
+		 * @brief IDFlowAggregate instance constructor for data counted elsewhere
+		 * @param ins Values on the left side of inter-dimensional flow
+		 * @param outs Values on the right side of inter-dimensional flow
+		 * @param total Number of counted rows
+		 */
+		explicit IDFlowAggregate(const IDFlowDimension& ins, const IDFlowDimension& outs, const double total) : mIns(ins), mOuts(outs), mTotal(total) {}
 
-			const Size topLeftTextSize = getTextSize(topLeftText, font, fontSize, 1, NULL);
-			putText(rect, topLeftText, Point2d(offset, topLeftTextSize.height + offset), font, fontSize, textColor, 1, LINE_AA);
+		/**
+		 * @brief Count a row of the data source
+		 * @param in Value on the left side of inter-dimensional flow
+		 * @param out Value on the right side of inter-dimensional flow
+		 * @param count Number of occurrences or weight of the row
+		 */
+		void add(const string_view in, const string_view out, const double count = 1) {
+			mIns.add(in, count);
+			mOuts.add(out, count);
+			mTotal += count;
+		}
 
-			const Size2i bottomRightTextSize = getTextSize(bottomRightText, font, fontSize, 1, NULL);
-			putText(rect, bottomRightText, Point2d(width - bottomRightTextSize.width - offset, height - offset - 2), font, fontSize, textColor, 1, LINE_AA);
+		/**
+		 * @brief Count many weighted rows of the data source at once
+		 * @param ins Values on the left side of inter-dimensional flow
+		 * @param outs Values on the right side of inter-dimensional flow
+		 * @param weights Weights of the rows
+		 */
+		template<typename TWeight>
+		void add(const span<const string_view> ins, const span<const string_view> outs, const span<const TWeight> weights) {
+			mIns.add(ins, weights);
+			mOuts.add(outs, weights);
 
-			rect.copyTo(image(Rect(x, y, rect.cols, rect.rows)));
+			double totals[4] = {};
+			size_t i = 0;
+			for (const size_t size = weights.size(); i + 4 <= size; i += 4) {
+				totals[0] += weights[i];
+				totals[1] += weights[i + 1];
+				totals[2] += weights[i + 2];
+				totals[3] += weights[i + 3];
+			}
+			for (const size_t size = weights.size(); i < size; i++)
+				totals[0] += weights[i];
+			mTotal += (totals[0] + totals[1]) + (totals[2] + totals[3]);
 		}
 
-		static double solveCubicEquation(double t, double a, double b, double c, double d) {
-			return pow(1 - t, 3) * a + 3 * t * pow(1 - t, 2) * b + 3 * pow(t, 2) * (1 - t) * c + pow(t, 3) * d;
+		/**
+		 * @brief Add all rows counted by another aggregate, as if its rows followed the rows of this one
+		 * @param other Aggregate to add
+		 */
+		void append(const IDFlowAggregate& other) {
+			mIns.append(other.mIns);
+			mOuts.append(other.mOuts);
+			mTotal += other.mTotal;
 		}
 
-		static void getCurvePoints(vector<Point2d>& points, const Point2d p0, const Point2d p3) {
-			const Point2d p1(p0.x + (p3.x - p0.x) / 3, p0.y);
-			const Point2d p2(p0.x + (p3.x - p0.x) * 2 / 3, p3.y);
+		/**
+		 * @brief Add all rows counted by another aggregate, e.g. a snapshot of another data source. Values are then ordered by name,
+		 *		  so merging the same aggregates in any order gives identical results as long as all counts are whole numbers. Sums of
+		 *		  fractional weights depend on the order of merging by the rounding of floating-point addition
+		 * @param other Aggregate to add
+		 */
+		void merge(const IDFlowAggregate& other) {
+			append(other);
+			mIns.sortByName();
+			mOuts.sortByName();
+		}
 
-			const int l = abs(p3.x - p0.x);
+		/**
+		 * @brief Write the aggregate to a compact binary snapshot
+		 * @param stream Output binary stream
+		 */
+		void serialize(ostream& stream) const {
+			IDFlowSnapshot::writeHeader(stream, SNAPSHOT_MAGIC);
+			mIns.serialize(stream);
+			mOuts.serialize(stream);
+			IDFlowSnapshot::writeNumber(stream, mTotal);
+		}
 
-			for (double i = 0; i <= l; i++)
-			{
-				const double t = i / l;
-				auto x = solveCubicEquation(t, p0.x, p1.x, p2.x, p3.x);
-				auto y = solveCubicEquation(t, p0.y, p1.y, p2.y, p3.y);
-				points.push_back(Point2d(x, y));
-			}
+		/**
+		 * @brief Read an aggregate from a binary snapshot written by serialize
+		 * @param stream Input binary stream
+		 * @return Aggregated data of inter-dimensional flow
+		 */
+		static IDFlowAggregate deserialize(istream& stream) {
+			IDFlowSnapshot::readHeader(stream, SNAPSHOT_MAGIC);
+			IDFlowDimension ins = IDFlowDimension::deserialize(stream);
+			IDFlowDimension outs = IDFlowDimension::deserialize(stream);
+			return IDFlowAggregate(ins, outs, IDFlowSnapshot::readNumber(stream));
 		}
 
-		static void drawFilledCurve(const Mat& img, const Point2d p0, const Point2d p3, const int leftHeight, const int rightHeight, const Scalar startColor, const Scalar endColor) {
+		/**
+		 * @brief Ins property getter
+		 * @return Values on the left side of inter-dimensional flow
+		 */
+		const IDFlowDimension& getIns() const { return mIns; }
+		/**
+		 * @brief Outs property getter
+		 * @return Values on the right side of inter-dimensional flow
+		 */
+		const IDFlowDimension& getOuts() const { return mOuts; }
+		/**
+		 * @brief Total property getter
+		 * @return Number of counted rows or sum of their weights
+		 */
+		double getTotal() const { return mTotal; }
+		/**
+		 * @brief Values on the left side of inter-dimensional flow
+		 */
+		__declspec(property(get = getIns)) const IDFlowDimension& Ins;
+		/**
+		 * @brief Values on the right side of inter-dimensional flow
+		 */
+		__declspec(property(get = getOuts)) const IDFlowDimension& Outs;
+		/**
+		 * @brief Number of counted rows or sum of their weights
+		 */
+		__declspec(property(get = getTotal)) double Total;
 
-			vector<Point2d> topPoints;
-			vector<Point2d> bottomPoints;
+	private:
+		static constexpr char SNAPSHOT_MAGIC[] = "IDFA";
 
-			getCurvePoints(topPoints, p0, p3);
-			getCurvePoints(bottomPoints, Point2d(p0.x, p0.y + leftHeight - 1), Point2d(p3.x, p3.y + rightHeight - 1));
+		IDFlowDimension mIns;
+		IDFlowDimension mOuts;
+		double mTotal = 0;
+	};
 
-			int size = topPoints.size();
+	/**
+	 * @brief Sparse matrix of joint counts of two dimensions of inter-dimensional flow, indexed by their dense ids.
+	 *		  Non-zero cells are kept as a list of (in id, out id, count) in order of first appearance, indexed by a flat open-addressing table
+	 */
+	class IDFlowPairs {
+	public:
+		/**
+		 * @brief Count a pair of values
+		 * @param inId Dense id of the value on the left side
+		 * @param outId Dense id of the value on the right side
+		 * @param count Number of occurrences of the pair
+		 */
+		void add(const size_t inId, const size_t outId, const double count = 1) {
+			mCounts[findOrAdd(inId, outId)] += count;
+		}
 
-			for (size_t i = 0; i < size; i++)
-				line(img, topPoints[i], bottomPoints[i], applyAlpha(startColor, endColor, 1 - ((double)i / (size - 1))));
+		/**
+		 * @brief Joint count of a pair of values
+		 * @param inId Dense id of the value on the left side
+		 * @param outId Dense id of the value on the right side
+		 * @return Number of rows (or sum of their weights) containing both values, 0 if there are none
+		 */
+		double count(const size_t inId, const size_t outId) const {
+			if (mSlots.empty())
+				return 0;
+
+			const uint64_t key = getKey(inId, outId);
+			const size_t mask = mSlots.size() - 1;
+			for (size_t slot = hashKey(key) & mask; mSlots[slot] != 0; slot = (slot + 1) & mask)
+				if (getKey(mInIds[mSlots[slot] - 1], mOutIds[mSlots[slot] - 1]) == key)
+					return mCounts[mSlots[slot] - 1];
+			return 0;
 		}
 
-		static void countValuesAndReorder(vector<IDFlowGroup>& result, const vector<string> source, const vector<pair<string, Scalar>> order, const Scalar defaultColor) {
+		/**
+		 * @brief Number of non-zero cells
+		 * @return Number of distinct pairs of values
+		 */
+		size_t size() const { return mCounts.size(); }
 
-			map<string, int> nameToOrder;
-			map<string, int> nameToCount;
-			map<string, Scalar> nameToColor;
+		/**
+		 * @brief Replace the ids of non-zero cells and order the cells by in id, then by out id
+		 * @param inIds New in ids, indexed by old in ids
+		 * @param outIds New out ids, indexed by old out ids
+		 */
+		void remap(const vector<size_t>& inIds, const vector<size_t>& outIds) {
+			vector<size_t> cells(mCounts.size());
+			for (size_t i = 0, size = cells.size(); i < size; i++)
+				cells[i] = i;
+			sort(cells.begin(), cells.end(), [&](size_t a, size_t b) {
+				return getKey(inIds[mInIds[a]], outIds[mOutIds[a]]) < getKey(inIds[mInIds[b]], outIds[mOutIds[b]]);
+			});
 
-			for (const pair<string, Scalar> value : order)
-				nameToColor[value.first] = value.second;
+			IDFlowPairs remapped;
+			for (const size_t i : cells)
+				remapped.add(inIds[mInIds[i]], outIds[mOutIds[i]], mCounts[i]);
+			*this = std::move(remapped);
+		}
 
-			for (const string value : source)
-				if (nameToCount.contains(value))
-					nameToCount[value] += 1;
-				else {
-					nameToOrder[value] = nameToOrder.size();
-					nameToCount[value] = 1;
-				}
+		/**
+		 * @brief Convert the matrix to compressed sparse rows, one row per in id. Cells of a row keep their order of first appearance
+		 * @param offsets Output vector of rowCount + 1 offsets; cells of row i are in [offsets[i], offsets[i + 1])
+		 * @param outIds Output vector of out ids of the cells
+		 * @param counts Output vector of counts of the cells
+		 * @param rowCount Number of rows, i.e. number of distinct values on the left side
+		 */
+		void getCompressedRows(vector<size_t>& offsets, vector<size_t>& outIds, vector<double>& counts, const size_t rowCount) const {
+			offsets.assign(rowCount + 1, 0);
+			for (const size_t inId : mInIds)
+				offsets.at(inId + 1)++;
+			for (size_t i = 1, size = offsets.size(); i < size; i++)
+				offsets[i] += offsets[i - 1];
 
-			for (size_t i = 0, size = order.size(); i < size; i++)
-			{
-				string name = order[i].first;
-				if (nameToOrder.contains(name) && nameToOrder[name] >= 0)
-					nameToOrder[name] = i - size;
+			vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+			outIds.resize(mCounts.size());
+			counts.resize(mCounts.size());
+			for (size_t i = 0, size = mCounts.size(); i < size; i++) {
+				const size_t position = positions[mInIds[i]]++;
+				outIds[position] = mOutIds[i];
+				counts[position] = mCounts[i];
 			}
-
-			vector<pair<string, int>> nameToOrderVec(nameToOrder.begin(), nameToOrder.end());
-			sort(nameToOrderVec.begin(), nameToOrderVec.end(), [](auto a, auto b) { return b.second > a.second; });
-			for (const pair p : nameToOrderVec)
-				result.push_back(IDFlowGroup(p.first, nameToCount[p.first], nameToColor.contains(p.first) ? nameToColor[p.first] : defaultColor));
 		}
 
-		static double getAlpha(int count, int totalCount) {
-			return ((1 - MINIMUM_ALPHA) * count / totalCount) + MINIMUM_ALPHA;
-		}
+		/**
+		 * @brief InIds property getter
+		 * @return In ids of non-zero cells in order of first appearance
+		 */
+		const vector<size_t>& getInIds() const { return mInIds; }
+		/**
+		 * @brief OutIds property getter
+		 * @return Out ids of non-zero cells in order of first appearance
+		 */
+		const vector<size_t>& getOutIds() const { return mOutIds; }
+		/**
+		 * @brief Counts property getter
+		 * @return Counts of non-zero cells in order of first appearance
+		 */
+		const vector<double>& getCounts() const { return mCounts; }
+		/**
+		 * @brief In ids of non-zero cells in order of first appearance
+		 */
+		__declspec(property(get = getInIds)) const vector<size_t>& InIds;
+		/**
+		 * @brief Out ids of non-zero cells in order of first appearance
+		 */
+		__declspec(property(get = getOutIds)) const vector<size_t>& OutIds;
+		/**
+		 * @brief Counts of non-zero cells in order of first appearance
+		 */
+		__declspec(property(get = getCounts)) const vector<double>& Counts;
 
-		static Scalar applyAlpha(Scalar fgColor, Scalar bgColor, double alpha) {
-			Scalar result;
+	private:
+		vector<size_t> mInIds;
+		vector<size_t> mOutIds;
+		vector<double> mCounts;
+		vector<size_t> mSlots;
 
-			for (size_t i = 0; i <= 2; i++)
-				result[i] = alpha * fgColor[i] + (1 - alpha) * bgColor[i];
+		static uint64_t getKey(const size_t inId, const size_t outId) {
+			return (static_cast<uint64_t>(inId) << 32) | static_cast<uint32_t>(outId);
+		}
 
-			return result;
+		static size_t hashKey(uint64_t key) {
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdULL;
+			key ^= key >> 33;
+			return static_cast<size_t>(key);
+		}
+
+		size_t findOrAdd(const size_t inId, const size_t outId) {
+			if ((mCounts.size() + 1) * 2 > mSlots.size()) {
+				mSlots.assign(max<size_t>(16, mSlots.size() * 2), 0);
+				const size_t mask = mSlots.size() - 1;
+				for (size_t i = 0, size = mCounts.size(); i < size; i++) {
+					size_t slot = hashKey(getKey(mInIds[i], mOutIds[i])) & mask;
+					while (mSlots[slot] != 0)
+						slot = (slot + 1) & mask;
+					mSlots[slot] = i + 1;
+				}
+			}
+
+			const uint64_t key = getKey(inId, outId);
+			const size_t mask = mSlots.size() - 1;
+			size_t slot = hashKey(key) & mask;
+			for (; mSlots[slot] != 0; slot = (slot + 1) & mask)
+				if (getKey(mInIds[mSlots[slot] - 1], mOutIds[mSlots[slot] - 1]) == key)
+					return mSlots[slot] - 1;
+
+			mSlots[slot] = mCounts.size() + 1;
+			mInIds.push_back(inId);
+			mOutIds.push_back(outId);
+			mCounts.push_back(0);
+			return mCounts.size() - 1;
+		}
+	};
+
+	/**
+	 * @brief Joint counts of the values on the left (in) and right (out) sides of inter-dimensional flow, stored as a sparse matrix over dense ids
+	 */
+	class IDFlowMatrix {
+	public:
+		/**
+		 * @brief Count a row of the data source
+		 * @param in Value on the left side of inter-dimensional flow
+		 * @param out Value on the right side of inter-dimensional flow
+		 * @param count Number of occurrences or weight of the row
+		 */
+		void add(const string_view in, const string_view out, const double count = 1) {
+			mPairs.add(mIns.add(in, count), mOuts.add(out, count), count);
+			mTotal += count;
+		}
+
+		/**
+		 * @brief Add all rows counted by another matrix, as if its rows followed the rows of this one
+		 * @param other Matrix to add
+		 */
+		void append(const IDFlowMatrix& other) {
+			for (size_t i = 0, size = other.mPairs.size(); i < size; i++)
+				add(other.mIns.Names[other.mPairs.InIds[i]], other.mOuts.Names[other.mPairs.OutIds[i]], other.mPairs.Counts[i]);
+		}
+
+		/**
+		 * @brief Joint count of a pair of values
+		 * @param inId Dense id of the value on the left side
+		 * @param outId Dense id of the value on the right side
+		 * @return Number of rows (or sum of their weights) containing both values, 0 if there are none
+		 */
+		double count(const size_t inId, const size_t outId) const { return mPairs.count(inId, outId); }
+
+		/**
+		 * @brief Number of non-zero cells
+		 * @return Number of distinct pairs of values
+		 */
+		size_t size() const { return mPairs.size(); }
+
+		/**
+		 * @brief Add all rows counted by another matrix, e.g. a snapshot of another data source. Values are then ordered by name
+		 *		  and cells by ids, so merging the same matrices in any order gives identical results as long as all counts are whole numbers.
+		 *		  Sums of fractional weights depend on the order of merging by the rounding of floating-point addition
+		 * @param other Matrix to add
+		 */
+		void merge(const IDFlowMatrix& other) {
+			append(other);
+			const vector<size_t> inIds = mIns.sortByName();
+			const vector<size_t> outIds = mOuts.sortByName();
+			mPairs.remap(inIds, outIds);
+		}
+
+		/**
+		 * @brief Write the matrix to a compact binary snapshot
+		 * @param stream Output binary stream
+		 */
+		void serialize(ostream& stream) const {
+			IDFlowSnapshot::writeHeader(stream, SNAPSHOT_MAGIC);
+			mIns.serialize(stream);
+			mOuts.serialize(stream);
+			IDFlowSnapshot::writeNumber(stream, mTotal);
+			IDFlowSnapshot::writeUnsigned(stream, mPairs.size());
+			for (size_t i = 0, size = mPairs.size(); i < size; i++) {
+				IDFlowSnapshot::writeUnsigned(stream, mPairs.InIds[i]);
+				IDFlowSnapshot::writeUnsigned(stream, mPairs.OutIds[i]);
+				IDFlowSnapshot::writeNumber(stream, mPairs.Counts[i]);
+			}
+		}
+
+		/**
+		 * @brief Read a matrix from a binary snapshot written by serialize
+		 * @param stream Input binary stream
+		 * @return Joint counts of inter-dimensional flow
+		 */
+		static IDFlowMatrix deserialize(istream& stream) {
+			IDFlowSnapshot::readHeader(stream, SNAPSHOT_MAGIC);
+
+			IDFlowMatrix result;
+			result.mIns = IDFlowDimension::deserialize(stream);
+			result.mOuts = IDFlowDimension::deserialize(stream);
+			result.mTotal = IDFlowSnapshot::readNumber(stream);
+			for (uint64_t i = 0, size = IDFlowSnapshot::readUnsigned(stream); i < size; i++) {
+				const size_t inId = IDFlowSnapshot::readId(stream, result.mIns.size());
+				const size_t outId = IDFlowSnapshot::readId(stream, result.mOuts.size());
+				if (result.mPairs.count(inId, outId) != 0)
+					throw invalid_argument("Duplicate cell in snapshot");
+				result.mPairs.add(inId, outId, IDFlowSnapshot::readNumber(stream));
+			}
+			return result;
+		}
+
+		/**
+		 * @brief Convert the matrix to compressed sparse rows, one row per in id. Cells of a row keep their order of first appearance
+		 * @param offsets Output vector of Ins.size() + 1 offsets; cells of row i are in [offsets[i], offsets[i + 1])
+		 * @param outIds Output vector of out ids of the cells
+		 * @param counts Output vector of counts of the cells
+		 */
+		void getCompressedRows(vector<size_t>& offsets, vector<size_t>& outIds, vector<double>& counts) const {
+			mPairs.getCompressedRows(offsets, outIds, counts, mIns.size());
+		}
+
+		/**
+		 * @brief Ins property getter
+		 * @return Values on the left side of inter-dimensional flow
+		 */
+		const IDFlowDimension& getIns() const { return mIns; }
+		/**
+		 * @brief Outs property getter
+		 * @return Values on the right side of inter-dimensional flow
+		 */
+		const IDFlowDimension& getOuts() const { return mOuts; }
+		/**
+		 * @brief Pairs property getter
+		 * @return Non-zero joint counts
+		 */
+		const IDFlowPairs& getPairs() const { return mPairs; }
+		/**
+		 * @brief Total property getter
+		 * @return Number of counted rows
+		 */
+		double getTotal() const { return mTotal; }
+		/**
+		 * @brief InIds property getter
+		 * @return In ids of non-zero cells in order of first appearance
+		 */
+		const vector<size_t>& getInIds() const { return mPairs.InIds; }
+		/**
+		 * @brief OutIds property getter
+		 * @return Out ids of non-zero cells in order of first appearance
+		 */
+		const vector<size_t>& getOutIds() const { return mPairs.OutIds; }
+		/**
+		 * @brief Counts property getter
+		 * @return Counts of non-zero cells in order of first appearance
+		 */
+		const vector<double>& getCounts() const { return mPairs.Counts; }
+		/**
+		 * @brief Values on the left side of inter-dimensional flow
+		 */
+		__declspec(property(get = getIns)) const IDFlowDimension& Ins;
+		/**
+		 * @brief Values on the right side of inter-dimensional flow
+		 */
+		__declspec(property(get = getOuts)) const IDFlowDimension& Outs;
+		/**
+		 * @brief Non-zero joint counts
+		 */
+		__declspec(property(get = getPairs)) const IDFlowPairs& Pairs;
+		/**
+		 * @brief Number of counted rows
+		 */
+		__declspec(property(get = getTotal)) double Total;
+		/**
+		 * @brief In ids of non-zero cells in order of first appearance
+		 */
+		__declspec(property(get = getInIds)) const vector<size_t>& InIds;
+		/**
+		 * @brief Out ids of non-zero cells in order of first appearance
+		 */
+		__declspec(property(get = getOutIds)) const vector<size_t>& OutIds;
+		/**
+		 * @brief Counts of non-zero cells in order of first appearance
+		 */
+		__declspec(property(get = getCounts)) const vector<double>& Counts;
+
+	private:
+		static constexpr char SNAPSHOT_MAGIC[] = "IDFM";
+
+		IDFlowDimension mIns;
+		IDFlowDimension mOuts;
+		IDFlowPairs mPairs;
+		double mTotal = 0;
+	};
+
+	/**
+	 * @brief Aggregated data of a multi-stage inter-dimensional flow: counts of the values of each stage and joint counts of adjacent stages.
+	 *		  Only pairs of adjacent stages are stored, so memory is proportional to the number of their distinct pairs
+	 */
+	class IDFlowStages {
+	public:
+		/**
+		 * @brief IDFlowStages instance constructor
+		 * @param stageCount Number of stages (columns) of inter-dimensional flow, at least 2
+		 */
+		explicit IDFlowStages(const size_t stageCount) {
+			if (stageCount < 2)
+				throw invalid_argument("Stage count must be at least 2");
+
+			mStages.resize(stageCount);
+			mPairs.resize(stageCount - 1);
+			mIds.resize(stageCount);
+		}
+
+		/**
+		 * @brief Count a row of the data source
+		 * @param values Values of the row, one per stage
+		 * @param count Number of occurrences or weight of the row
+		 */
+		void add(const span<const string_view> values, const double count = 1) {
+			if (values.size() != mStages.size())
+				throw invalid_argument("Row must have one value per stage");
+
+			for (size_t i = 0, size = mStages.size(); i < size; i++)
+				mIds[i] = mStages[i].add(values[i], count);
+			for (size_t i = 0, size = mPairs.size(); i < size; i++)
+				mPairs[i].add(mIds[i], mIds[i + 1], count);
+			mTotal += count;
+		}
+
+		/**
+		 * @brief Count a row of the data source
+		 * @param values Values of the row, one per stage
+		 * @param count Number of occurrences or weight of the row
+		 */
+		void add(const vector<string>& values, const double count = 1) {
+			vector<string_view> views(values.begin(), values.end());
+			add(span<const string_view>(views), count);
+		}
+
+		/**
+		 * @brief Add all rows counted by another instance with the same number of stages, as if its rows followed the rows of this one
+		 * @param other Stages to add
+		 */
+		void append(const IDFlowStages& other) {
+			if (other.mStages.size() != mStages.size())
+				throw invalid_argument("Stage counts must be equal");
+
+			vector<vector<size_t>> ids(mStages.size());
+			for (size_t i = 0, size = mStages.size(); i < size; i++) {
+				const IDFlowDimension& stage = other.mStages[i];
+				for (size_t id = 0; id < stage.size(); id++)
+					ids[i].push_back(mStages[i].add(stage.Names[id], stage.Counts[id]));
+			}
+			for (size_t i = 0, size = mPairs.size(); i < size; i++) {
+				const IDFlowPairs& pairs = other.mPairs[i];
+				for (size_t j = 0; j < pairs.size(); j++)
+					mPairs[i].add(ids[i][pairs.InIds[j]], ids[i + 1][pairs.OutIds[j]], pairs.Counts[j]);
+			}
+			mTotal += other.mTotal;
+		}
+
+		/**
+		 * @brief Number of stages
+		 * @return Number of stages
+		 */
+		size_t size() const { return mStages.size(); }
+		/**
+		 * @brief Stages property getter
+		 * @return Values of each stage
+		 */
+		const vector<IDFlowDimension>& getStages() const { return mStages; }
+		/**
+		 * @brief Pairs property getter
+		 * @return Joint counts of each stage and the next one
+		 */
+		const vector<IDFlowPairs>& getPairs() const { return mPairs; }
+		/**
+		 * @brief Total property getter
+		 * @return Number of counted rows
+		 */
+		double getTotal() const { return mTotal; }
+		/**
+		 * @brief Values of each stage
+		 */
+		__declspec(property(get = getStages)) const vector<IDFlowDimension>& Stages;
+		/**
+		 * @brief Joint counts of each stage and the next one
+		 */
+		__declspec(property(get = getPairs)) const vector<IDFlowPairs>& Pairs;
+		/**
+		 * @brief Number of counted rows
+		 */
+		__declspec(property(get = getTotal)) double Total;
+
+	private:
+		vector<IDFlowDimension> mStages;
+		vector<IDFlowPairs> mPairs;
+		vector<size_t> mIds;
+		double mTotal = 0;
+	};
+
+	/**
+	 * @brief Approximate counts of the most frequent values of one dimension of inter-dimensional flow (Space-Saving summary).
+	 *		  At most Capacity values are monitored, so memory does not depend on the length or the cardinality of the data.
+	 *		  Every count is an overestimation: the exact count of a monitored value is between Counts[i] - Errors[i] and Counts[i],
+	 *		  and a value that is not monitored occurs at most MaxError <= Total / Capacity times
+	 */
+	class IDFlowHeavyHitters {
+	public:
+		/**
+		 * @brief IDFlowHeavyHitters instance constructor
+		 * @param capacity Maximum number of monitored values
+		 */
+		explicit IDFlowHeavyHitters(const size_t capacity) {
+			if (capacity == 0)
+				throw invalid_argument("Capacity must be greater than 0");
+			mCapacity = capacity;
+		}
+
+		/**
+		 * @brief Count occurrences of a value. If the value is not monitored and all counters are in use, it replaces the least frequent value
+		 * @param name Value from the data source
+		 * @param count Number of occurrences or weight to add
+		 */
+		void add(const string_view name, const double count = 1) {
+			mTotal += count;
+
+			const auto it = mIds.find(name);
+			if (it != mIds.end()) {
+				mCounts[it->second] += count;
+				siftDown(mHeapPositions[it->second]);
+				return;
+			}
+
+			if (mNames.size() < mCapacity) {
+				const size_t id = mNames.size();
+				mNames.emplace_back(name);
+				mCounts.push_back(count);
+				mErrors.push_back(0);
+				mIds.emplace(mNames.back(), id);
+				mHeapPositions.push_back(mHeap.size());
+				mHeap.push_back(id);
+				siftUp(mHeap.size() - 1);
+				return;
+			}
+
+			const size_t id = mHeap.front();
+			mIds.erase(mIds.find(mNames[id]));
+			mNames[id] = name;
+			mErrors[id] = mCounts[id];
+			mCounts[id] += count;
+			mIds.emplace(mNames[id], id);
+			siftDown(0);
+		}
+
+		/**
+		 * @brief Add all values counted by another summary. The error bounds of both summaries are added
+		 * @param other Summary to add
+		 */
+		void append(const IDFlowHeavyHitters& other) {
+			const double minimum = getMaxError();
+			const double otherMinimum = other.getMaxError();
+
+			vector<string> names;
+			vector<double> counts;
+			vector<double> errors;
+
+			for (size_t id = 0, size = mNames.size(); id < size; id++) {
+				const auto it = other.mIds.find(mNames[id]);
+				names.push_back(mNames[id]);
+				counts.push_back(mCounts[id] + (it == other.mIds.end() ? otherMinimum : other.mCounts[it->second]));
+				errors.push_back(mErrors[id] + (it == other.mIds.end() ? otherMinimum : other.mErrors[it->second]));
+			}
+			for (size_t id = 0, size = other.mNames.size(); id < size; id++) {
+				if (mIds.find(other.mNames[id]) != mIds.end())
+					continue;
+				names.push_back(other.mNames[id]);
+				counts.push_back(other.mCounts[id] + minimum);
+				errors.push_back(other.mErrors[id] + minimum);
+			}
+
+			vector<size_t> ids(names.size());
+			for (size_t i = 0, size = ids.size(); i < size; i++)
+				ids[i] = i;
+			if (ids.size() > mCapacity) {
+				nth_element(ids.begin(), ids.begin() + mCapacity, ids.end(),
+					[&](size_t a, size_t b) { return counts[a] != counts[b] ? counts[a] > counts[b] : names[a] < names[b]; });
+				ids.resize(mCapacity);
+			}
+
+			const double total = mTotal + other.mTotal;
+			*this = IDFlowHeavyHitters(mCapacity);
+			for (const size_t id : ids) {
+				add(names[id], counts[id]);
+				mErrors.back() = errors[id];
+			}
+			mTotal = total;
+		}
+
+		/**
+		 * @brief Convert the summary to a dimension of inter-dimensional flow, ordered by descending count
+		 * @return Monitored values and their estimated counts
+		 */
+		IDFlowDimension toDimension() const {
+			vector<size_t> ids(mNames.size());
+			for (size_t i = 0, size = ids.size(); i < size; i++)
+				ids[i] = i;
+			sort(ids.begin(), ids.end(), [this](size_t a, size_t b) { return mCounts[a] != mCounts[b] ? mCounts[a] > mCounts[b] : mNames[a] < mNames[b]; });
+
+			IDFlowDimension result;
+			for (const size_t id : ids)
+				result.add(mNames[id], mCounts[id]);
+			return result;
+		}
+
+		/**
+		 * @brief Number of monitored values
+		 * @return Number of monitored values
+		 */
+		size_t size() const { return mNames.size(); }
+		/**
+		 * @brief Capacity property getter
+		 * @return Maximum number of monitored values
+		 */
+		size_t getCapacity() const { return mCapacity; }
+		/**
+		 * @brief Names property getter
+		 * @return Monitored values, in no particular order
+		 */
+		const vector<string>& getNames() const { return mNames; }
+		/**
+		 * @brief Counts property getter
+		 * @return Estimated counts of monitored values, indexed as Names
+		 */
+		const vector<double>& getCounts() const { return mCounts; }
+		/**
+		 * @brief Errors property getter
+		 * @return Maximum overestimation of the counts of monitored values, indexed as Names
+		 */
+		const vector<double>& getErrors() const { return mErrors; }
+		/**
+		 * @brief MaxError property getter
+		 * @return Maximum count of a value that is not monitored, which also bounds every value of Errors
+		 */
+		double getMaxError() const { return mNames.size() < mCapacity ? 0 : mCounts[mHeap.front()]; }
+		/**
+		 * @brief Total property getter
+		 * @return Number of counted occurrences
+		 */
+		double getTotal() const { return mTotal; }
+		/**
+		 * @brief Maximum number of monitored values
+		 */
+		__declspec(property(get = getCapacity)) size_t Capacity;
+		/**
+		 * @brief Monitored values, in no particular order
+		 */
+		__declspec(property(get = getNames)) const vector<string>& Names;
+		/**
+		 * @brief Estimated counts of monitored values, indexed as Names
+		 */
+		__declspec(property(get = getCounts)) const vector<double>& Counts;
+		/**
+		 * @brief Maximum overestimation of the counts of monitored values, indexed as Names
+		 */
+		__declspec(property(get = getErrors)) const vector<double>& Errors;
+		/**
+		 * @brief Maximum count of a value that is not monitored, which also bounds every value of Errors
+		 */
+		__declspec(property(get = getMaxError)) double MaxError;
+		/**
+		 * @brief Number of counted occurrences
+		 */
+		__declspec(property(get = getTotal)) double Total;
+
+	private:
+		struct StringHash {
+			using is_transparent = void;
+			size_t operator() (const string_view value) const { return hash<string_view>{}(value); }
+		};
+
+		size_t mCapacity;
+		double mTotal = 0;
+		vector<string> mNames;
+		vector<double> mCounts;
+		vector<double> mErrors;
+		vector<size_t> mHeap;
+		vector<size_t> mHeapPositions;
+		unordered_map<string, size_t, StringHash, equal_to<>> mIds;
+
+		void swapHeap(const size_t a, const size_t b) {
+			swap(mHeap[a], mHeap[b]);
+			mHeapPositions[mHeap[a]] = a;
+			mHeapPositions[mHeap[b]] = b;
+		}
+
+		void siftUp(size_t position) {
+			while (position > 0) {
+				const size_t parent = (position - 1) / 2;
+				if (mCounts[mHeap[parent]] <= mCounts[mHeap[position]])
+					break;
+				swapHeap(parent, position);
+				position = parent;
+			}
+		}
+
+		void siftDown(size_t position) {
+			for (size_t size = mHeap.size();;) {
+				const size_t left = 2 * position + 1;
+				const size_t right = left + 1;
+				size_t smallest = position;
+				if (left < size && mCounts[mHeap[left]] < mCounts[mHeap[smallest]])
+					smallest = left;
+				if (right < size && mCounts[mHeap[right]] < mCounts[mHeap[smallest]])
+					smallest = right;
+				if (smallest == position)
+					break;
+				swapHeap(smallest, position);
+				position = smallest;
+			}
+		}
+	};
+
+	/**
+	 * @brief Approximate aggregated data of inter-dimensional flow with bounded memory: a heavy-hitter summary of each side
+	 */
+	class IDFlowSketch {
+	public:
+		/**
+		 * @brief IDFlowSketch instance constructor
+		 * @param capacity Maximum number of monitored values on each side
+		 */
+		explicit IDFlowSketch(const size_t capacity) : mIns(capacity), mOuts(capacity) {}
+
+		/**
+		 * @brief Count a row of the data source
+		 * @param in Value on the left side of inter-dimensional flow
+		 * @param out Value on the right side of inter-dimensional flow
+		 * @param count Number of occurrences or weight of the row
+		 */
+		void add(const string_view in, const string_view out, const double count = 1) {
+			mIns.add(in, count);
+			mOuts.add(out, count);
+		}
+
+		/**
+		 * @brief Add all rows counted by another sketch
+		 * @param other Sketch to add
+		 */
+		void append(const IDFlowSketch& other) {
+			mIns.append(other.mIns);
+			mOuts.append(other.mOuts);
+		}
+
+		/**
+		 * @brief Convert the sketch to aggregated data of inter-dimensional flow with estimated counts, ordered by descending count
+		 * @return Aggregated data of inter-dimensional flow
+		 */
+		IDFlowAggregate toAggregate() const {
+			return IDFlowAggregate(mIns.toDimension(), mOuts.toDimension(), getTotal());
+		}
+
+		/**
+		 * @brief Ins property getter
+		 * @return Summary of the left side of inter-dimensional flow
+		 */
+		const IDFlowHeavyHitters& getIns() const { return mIns; }
+		/**
+		 * @brief Outs property getter
+		 * @return Summary of the right side of inter-dimensional flow
+		 */
+		const IDFlowHeavyHitters& getOuts() const { return mOuts; }
+		/**
+		 * @brief Total property getter
+		 * @return Number of counted rows
+		 */
+		double getTotal() const { return mIns.Total; }
+		/**
+		 * @brief Summary of the left side of inter-dimensional flow
+		 */
+		__declspec(property(get = getIns)) const IDFlowHeavyHitters& Ins;
+		/**
+		 * @brief Summary of the right side of inter-dimensional flow
+		 */
+		__declspec(property(get = getOuts)) const IDFlowHeavyHitters& Outs;
+		/**
+		 * @brief Number of counted rows
+		 */
+		__declspec(property(get = getTotal)) double Total;
+
+	private:
+		IDFlowHeavyHitters mIns;
+		IDFlowHeavyHitters mOuts;
+	};
+
+	/**
+	 * @brief Aggregated data of inter-dimensional flow over a sliding time window. The window is split into buckets of equal width
+	 *		  kept in a ring buffer; each bucket holds the counts added during its time span, which are subtracted again when the bucket
+	 *		  leaves the window. Advancing the window therefore costs as many buckets as it moves, independently of the number of rows
+	 */
+	class IDFlowWindow {
+	public:
+		/**
+		 * @brief IDFlowWindow instance constructor
+		 * @param bucketCount Number of buckets in the window
+		 * @param bucketWidth Time span of a bucket, in units of timestamps (e.g. 1 for per-second buckets of Unix time)
+		 */
+		explicit IDFlowWindow(const size_t bucketCount, const int64_t bucketWidth = 1) {
+			if (bucketCount == 0)
+				throw invalid_argument("Bucket count must be greater than 0");
+			if (bucketWidth <= 0)
+				throw invalid_argument("Bucket width must be greater than 0");
+
+			mBuckets.resize(bucketCount);
+			mBucketWidth = bucketWidth;
+		}
+
+		/**
+		 * @brief Count a row of the data source. The window is first advanced to the timestamp of the row
+		 * @param time Timestamp of the row
+		 * @param in Value on the left side of inter-dimensional flow
+		 * @param out Value on the right side of inter-dimensional flow
+		 * @param count Number of occurrences or weight of the row
+		 * @return false if the row is older than the window and has not been counted, true otherwise
+		 */
+		bool add(const int64_t time, const string_view in, const string_view out, const double count = 1) {
+			advance(time);
+
+			const int64_t bucket = getBucket(time);
+			if (bucket <= mEnd - static_cast<int64_t>(mBuckets.size()))
+				return false;
+
+			IDFlowBucket& target = mBuckets[getSlot(bucket)];
+			const size_t inId = mIns.Values.add(in, 0);
+			const size_t outId = mOuts.Values.add(out, 0);
+			const auto inDelta = target.InDeltas.try_emplace(inId, 0);
+			const auto outDelta = target.OutDeltas.try_emplace(outId, 0);
+			inDelta.first->second += count;
+			outDelta.first->second += count;
+			target.TotalDelta += count;
+			addCount(mIns, inId, count, inDelta.second ? 1 : 0);
+			addCount(mOuts, outId, count, outDelta.second ? 1 : 0);
+			mTotal += count;
+			return true;
+		}
+
+		/**
+		 * @brief Move the end of the window forward so that it contains the given time. Buckets leaving the window are subtracted
+		 * @param time New end of the window. Times not after the current end are ignored
+		 */
+		void advance(const int64_t time) {
+			const int64_t bucket = getBucket(time);
+			if (!mStarted) {
+				mStarted = true;
+				mEnd = bucket;
+				return;
+			}
+			if (bucket <= mEnd)
+				return;
+
+			for (int64_t b = max(mEnd + 1, bucket - static_cast<int64_t>(mBuckets.size()) + 1); b <= bucket; b++)
+				expire(mBuckets[getSlot(b)]);
+			mEnd = bucket;
+
+			if (mIns.Values.size() > 2 * mIns.Live + COMPACTION_THRESHOLD || mOuts.Values.size() > 2 * mOuts.Live + COMPACTION_THRESHOLD)
+				compact();
+		}
+
+		/**
+		 * @brief Convert the window to aggregated data of inter-dimensional flow. Values without rows in the window are omitted
+		 * @return Aggregated data of inter-dimensional flow
+		 */
+		IDFlowAggregate toAggregate() const {
+			return IDFlowAggregate(toDimension(mIns), toDimension(mOuts), mTotal);
+		}
+
+		/**
+		 * @brief BucketCount property getter
+		 * @return Number of buckets in the window
+		 */
+		size_t getBucketCount() const { return mBuckets.size(); }
+		/**
+		 * @brief BucketWidth property getter
+		 * @return Time span of a bucket
+		 */
+		int64_t getBucketWidth() const { return mBucketWidth; }
+		/**
+		 * @brief End property getter
+		 * @return Exclusive upper bound of the times in the window
+		 */
+		int64_t getEnd() const { return (mEnd + 1) * mBucketWidth; }
+		/**
+		 * @brief Total property getter
+		 * @return Number of rows in the window or sum of their weights
+		 */
+		double getTotal() const { return mTotal; }
+		/**
+		 * @brief Number of buckets in the window
+		 */
+		__declspec(property(get = getBucketCount)) size_t BucketCount;
+		/**
+		 * @brief Time span of a bucket
+		 */
+		__declspec(property(get = getBucketWidth)) int64_t BucketWidth;
+		/**
+		 * @brief Exclusive upper bound of the times in the window
+		 */
+		__declspec(property(get = getEnd)) int64_t End;
+		/**
+		 * @brief Number of rows in the window or sum of their weights
+		 */
+		__declspec(property(get = getTotal)) double Total;
+
+	private:
+		static const size_t COMPACTION_THRESHOLD = 1024;
+
+		struct IDFlowBucket {
+			unordered_map<size_t, double> InDeltas;
+			unordered_map<size_t, double> OutDeltas;
+			double TotalDelta = 0;
+		};
+
+		struct IDFlowSide {
+			IDFlowDimension Values;
+			vector<double> Totals;
+			vector<size_t> Buckets;
+			size_t Live = 0;
+		};
+
+		vector<IDFlowBucket> mBuckets;
+		int64_t mBucketWidth;
+		int64_t mEnd = 0;
+		bool mStarted = false;
+		IDFlowSide mIns;
+		IDFlowSide mOuts;
+		double mTotal = 0;
+
+		int64_t getBucket(const int64_t time) const {
+			return time / mBucketWidth - (time % mBucketWidth < 0 ? 1 : 0);
+		}
+
+		size_t getSlot(const int64_t bucket) const {
+			const int64_t size = static_cast<int64_t>(mBuckets.size());
+			return static_cast<size_t>((bucket % size + size) % size);
+		}
+
+		// a value is in the window while a bucket holds a delta for it; its total is reset exactly when the last one expires,
+		// so that rounding errors of weights do not keep it alive
+		static void addCount(IDFlowSide& side, const size_t id, const double count, const int buckets) {
+			if (id >= side.Totals.size()) {
+				side.Totals.resize(id + 1, 0);
+				side.Buckets.resize(id + 1, 0);
+			}
+
+			side.Totals[id] += count;
+			if (buckets > 0 && side.Buckets[id]++ == 0)
+				side.Live++;
+			else if (buckets < 0 && --side.Buckets[id] == 0) {
+				side.Live--;
+				side.Totals[id] = 0;
+			}
+		}
+
+		void expire(IDFlowBucket& bucket) {
+			for (const auto& [id, count] : bucket.InDeltas)
+				addCount(mIns, id, -count, -1);
+			for (const auto& [id, count] : bucket.OutDeltas)
+				addCount(mOuts, id, -count, -1);
+			mTotal = mIns.Live == 0 ? 0 : mTotal - bucket.TotalDelta;
+
+			bucket.InDeltas.clear();
+			bucket.OutDeltas.clear();
+			bucket.TotalDelta = 0;
+		}
+
+		void compact() {
+			const vector<size_t> inIds = compact(mIns);
+			const vector<size_t> outIds = compact(mOuts);
+
+			for (IDFlowBucket& bucket : mBuckets) {
+				unordered_map<size_t, double> ins;
+				unordered_map<size_t, double> outs;
+				for (const auto& [id, count] : bucket.InDeltas)
+					ins[inIds[id]] = count;
+				for (const auto& [id, count] : bucket.OutDeltas)
+					outs[outIds[id]] = count;
+				bucket.InDeltas = std::move(ins);
+				bucket.OutDeltas = std::move(outs);
+			}
+		}
+
+		static vector<size_t> compact(IDFlowSide& side) {
+			IDFlowSide result;
+			vector<size_t> ids(side.Values.size(), SIZE_MAX);
+			for (size_t id = 0, size = side.Values.size(); id < size; id++) {
+				if (side.Buckets[id] == 0)
+					continue;
+				ids[id] = result.Values.add(side.Values.Names[id], 0);
+				result.Totals.push_back(side.Totals[id]);
+				result.Buckets.push_back(side.Buckets[id]);
+			}
+			result.Live = side.Live;
+			side = std::move(result);
+			return ids;
+		}
+
+		static IDFlowDimension toDimension(const IDFlowSide& side) {
+			IDFlowDimension result;
+			for (size_t id = 0, size = side.Values.size(); id < size; id++)
+				if (side.Buckets[id] != 0)
+					result.add(side.Values.Names[id], side.Totals[id]);
+			return result;
+		}
+	};
+
+	/**
+	 * @brief Figure of an inter-dimensional flow: either a rectangle of a group or a ribbon connecting two groups
+	 */
+	class IDFlowShape {
+	public:
+		/**
+		 * @brief Rectangle of a group
+		 * @param bounds Position and size of the rectangle
+		 * @param fill Color of the rectangle
+		 * @param label Name of the group, drawn in the top left corner
+		 * @param caption Count of the group, drawn in the bottom right corner
+		 * @param total Count of the group
+		 */
+		explicit IDFlowShape(const Rect& bounds, const Scalar& fill, const string& label, const string& caption, const double total)
+			: mRibbon(false), mBounds(bounds), mSource(bounds.x, bounds.y), mTarget(bounds.x + bounds.width, bounds.y), mSourceHeight(bounds.height),
+			mTargetHeight(bounds.height), mFill(fill), mTargetFill(fill), mLabel(label), mCaption(caption), mTotal(total) {}
+
+		/**
+		 * @brief Ribbon between two groups. Its top and bottom edges are cubic Bezier curves and its color fades from one end to the other
+		 * @param source Top point of the ribbon at the group it starts from
+		 * @param target Top point of the ribbon at the group it ends at
+		 * @param sourceHeight Height of the ribbon at the start
+		 * @param targetHeight Height of the ribbon at the end
+		 * @param fill Color of the ribbon at the start
+		 * @param targetFill Color of the ribbon at the end
+		 * @param label Name of the group, or of the pair of groups, the ribbon stands for. It is not drawn
+		 * @param caption Count of the ribbon. It is not drawn
+		 * @param total Count of the ribbon
+		 */
+		explicit IDFlowShape(const Point2d& source, const Point2d& target, const int sourceHeight, const int targetHeight, const Scalar& fill, const Scalar& targetFill,
+			const string& label, const string& caption, const double total)
+			: mRibbon(true), mSource(source), mTarget(target), mSourceHeight(sourceHeight), mTargetHeight(targetHeight), mFill(fill), mTargetFill(targetFill),
+			mLabel(label), mCaption(caption), mTotal(total) {
+
+			// the curves stay between the heights of their ends; one extra pixel on each side covers rounding
+			const int left = static_cast<int>(floor(min(source.x, target.x))) - 1;
+			const int right = static_cast<int>(ceil(max(source.x, target.x))) + 1;
+			const int top = static_cast<int>(floor(min(source.y, target.y))) - 1;
+			const int bottom = static_cast<int>(ceil(max(source.y + sourceHeight, target.y + targetHeight))) + 1;
+			mBounds = Rect(left, top, right - left + 1, bottom - top + 1);
+		}
+
+		bool operator==(const IDFlowShape& other) const = default;
+
+		/**
+		 * @brief Ribbon property getter
+		 * @return true for a ribbon, false for a rectangle
+		 */
+		bool isRibbon() const { return mRibbon; }
+		/**
+		 * @brief Bounds property getter
+		 * @return The rectangle itself, or the area a ribbon can draw on
+		 */
+		Rect getBounds() const { return mBounds; }
+		/**
+		 * @brief Source property getter
+		 * @return Top point of a ribbon at its start, or the top left corner of a rectangle
+		 */
+		Point2d getSource() const { return mSource; }
+		/**
+		 * @brief Target property getter
+		 * @return Top point of a ribbon at its end, or the top right corner of a rectangle
+		 */
+		Point2d getTarget() const { return mTarget; }
+		/**
+		 * @brief SourceHeight property getter
+		 * @return Height of a ribbon at its start, or the height of a rectangle
+		 */
+		int getSourceHeight() const { return mSourceHeight; }
+		/**
+		 * @brief TargetHeight property getter
+		 * @return Height of a ribbon at its end, or the height of a rectangle
+		 */
+		int getTargetHeight() const { return mTargetHeight; }
+		/**
+		 * @brief Fill property getter
+		 * @return Color of a rectangle, or of a ribbon at its start
+		 */
+		Scalar getFill() const { return mFill; }
+		/**
+		 * @brief TargetFill property getter
+		 * @return Color of a ribbon at its end, or the color of a rectangle
+		 */
+		Scalar getTargetFill() const { return mTargetFill; }
+		/**
+		 * @brief Label property getter
+		 * @return Name of the group of a rectangle, or of the group or the pair of groups of a ribbon
+		 */
+		const string& getLabel() const { return mLabel; }
+		/**
+		 * @brief Caption property getter
+		 * @return Formatted count of a rectangle or a ribbon
+		 */
+		const string& getCaption() const { return mCaption; }
+		/**
+		 * @brief Total property getter
+		 * @return Count of a rectangle or a ribbon
+		 */
+		double getTotal() const { return mTotal; }
+
+		__declspec(property(get = isRibbon)) bool Ribbon;
+		__declspec(property(get = getBounds)) Rect Bounds;
+		__declspec(property(get = getSource)) Point2d Source;
+		__declspec(property(get = getTarget)) Point2d Target;
+		__declspec(property(get = getSourceHeight)) int SourceHeight;
+		__declspec(property(get = getTargetHeight)) int TargetHeight;
+		__declspec(property(get = getFill)) Scalar Fill;
+		__declspec(property(get = getTargetFill)) Scalar TargetFill;
+		__declspec(property(get = getLabel)) const string& Label;
+		__declspec(property(get = getCaption)) const string& Caption;
+		__declspec(property(get = getTotal)) double Total;
+
+	private:
+		bool mRibbon;
+		Rect mBounds;
+		Point2d mSource;
+		Point2d mTarget;
+		int mSourceHeight;
+		int mTargetHeight;
+		Scalar mFill;
+		Scalar mTargetFill;
+		string mLabel;
+		string mCaption;
+		double mTotal;
+	};
+
+	/**
+	 * @brief Geometry of an inter-dimensional flow: the size of its image and its figures in the order they are drawn
+	 */
+	class IDFlowLayout {
+	public:
+		IDFlowLayout() : mWidth(0), mHeight(0), mCountPerPixel(0) {}
+
+		/**
+		 * @brief IDFlowLayout instance constructor
+		 * @param width Width of the image
+		 * @param height Height of the image
+		 * @param bgColor Background color of the image
+		 * @param countPerPixel Count per pixel the figures were computed with
+		 * @param shapes Figures in the order they are drawn
+		 */
+		explicit IDFlowLayout(const int width, const int height, const Scalar& bgColor, const double countPerPixel, vector<IDFlowShape> shapes)
+			: mWidth(width), mHeight(height), mBgColor(bgColor), mCountPerPixel(countPerPixel), mShapes(std::move(shapes)) {}
+
+		/**
+		 * @brief Width property getter
+		 * @return Width of the image
+		 */
+		int getWidth() const { return mWidth; }
+		/**
+		 * @brief Height property getter
+		 * @return Height of the image
+		 */
+		int getHeight() const { return mHeight; }
+		/**
+		 * @brief BgColor property getter
+		 * @return Background color of the image
+		 */
+		Scalar getBgColor() const { return mBgColor; }
+		/**
+		 * @brief CountPerPixel property getter
+		 * @return Count per pixel the figures were computed with, e.g. the one fitted into a fixed ImageHeight
+		 */
+		double getCountPerPixel() const { return mCountPerPixel; }
+		/**
+		 * @brief Shapes property getter
+		 * @return Figures in the order they are drawn
+		 */
+		const vector<IDFlowShape>& getShapes() const { return mShapes; }
+
+		__declspec(property(get = getWidth)) int Width;
+		__declspec(property(get = getHeight)) int Height;
+		__declspec(property(get = getBgColor)) Scalar BgColor;
+		__declspec(property(get = getCountPerPixel)) double CountPerPixel;
+		__declspec(property(get = getShapes)) const vector<IDFlowShape>& Shapes;
+
+	private:
+		int mWidth;
+		int mHeight;
+		Scalar mBgColor;
+		double mCountPerPixel;
+		vector<IDFlowShape> mShapes;
+	};
+
+	/**
+	 * @brief Finds the figure of an inter-dimensional flow drawn at a point of its image, e.g. under the mouse cursor. Rectangles are kept in an interval
+	 *		  tree over their columns. Ribbons between the same columns make a band, which keeps for every column of the image the runs of rows where one
+	 *		  ribbon is drawn on top, sorted by row. A lookup takes one binary search per band under the point, however the ribbons cross; the runs take
+	 *		  memory in proportion to the number of ribbons times the width of their band
+	 */
+	class IDFlowHitIndex {
+	public:
+		IDFlowHitIndex() : mRoot(-1) {}
+
+		/**
+		 * @brief IDFlowHitIndex instance constructor
+		 * @param pLayout Layout of inter-dimensional flow
+		 */
+		explicit IDFlowHitIndex(const IDFlowLayout& pLayout) : mLayout(pLayout) {
+			const vector<IDFlowShape>& shapes = mLayout.Shapes;
+
+			vector<size_t> rectangles;
+			map<pair<double, double>, vector<size_t>> bands;
+			for (size_t i = 0, size = shapes.size(); i < size; i++)
+				if (shapes[i].Ribbon)
+					bands[{ shapes[i].Source.x, shapes[i].Target.x }].push_back(i);
+				else
+					rectangles.push_back(i);
+
+			mRoot = buildNode(rectangles);
+			for (auto& band : bands)
+				mBands.push_back(buildBand(band.first.first, band.first.second, band.second));
+		}
+
+		/**
+		 * @brief Find the figure drawn at a point of the image. Where figures overlap, the one drawn last is found
+		 * @param x Column of the image
+		 * @param y Row of the image
+		 * @return Rectangle or ribbon with its label and count, or nullptr if there is only the background at the point
+		 */
+		const IDFlowShape* hitTest(const int x, const int y) const {
+			const vector<IDFlowShape>& shapes = mLayout.Shapes;
+			ptrdiff_t hit = -1;
+
+			for (int n = mRoot; n >= 0; n = x < mNodes[n].Center ? mNodes[n].Before : mNodes[n].After) {
+				const IDFlowRectNode& node = mNodes[n];
+				const size_t last = upper_bound(node.Items.begin(), node.Items.end(), y, [&](const int row, const size_t i) { return row < shapes[i].Bounds.y; }) - node.Items.begin();
+				for (size_t k = last; k > 0 && node.Bottoms[k - 1] > y; k--)
+					if (shapes[node.Items[k - 1]].Bounds.contains(Point(x, y)))
+						hit = max(hit, static_cast<ptrdiff_t>(node.Items[k - 1]));
+				if (x == node.Center)
+					break;
+			}
+
+			for (const IDFlowRibbonBand& band : mBands) {
+				if (x < min(band.From, band.To) || x > max(band.From, band.To))
+					continue;
+
+				// the first run of a column starts above the image, so the run containing the row is the one before the first run below it
+				const auto first = band.Runs.begin() + band.Columns[x - band.Left];
+				const auto last = band.Runs.begin() + band.Columns[x - band.Left + 1];
+				const auto run = upper_bound(first, last, y, [](const int row, const IDFlowRibbonRun& r) { return row < r.Top; }) - 1;
+				hit = max(hit, static_cast<ptrdiff_t>(run->Shape));
+			}
+
+			return hit < 0 ? nullptr : &shapes[hit];
+		}
+
+		/**
+		 * @brief Layout property getter
+		 * @return Layout of inter-dimensional flow
+		 */
+		const IDFlowLayout& getLayout() const { return mLayout; }
+
+		__declspec(property(get = getLayout)) const IDFlowLayout& Layout;
+
+	private:
+		struct IDFlowRectNode {
+			int Center;
+			vector<size_t> Items;
+			vector<int> Bottoms;
+			int Before;
+			int After;
+		};
+
+		struct IDFlowRibbonRun {
+			int Top;
+			int Shape;
+		};
+
+		struct IDFlowRibbonBand {
+			double From;
+			double To;
+			int Left;
+			vector<size_t> Columns;
+			vector<IDFlowRibbonRun> Runs;
+		};
+
+		IDFlowLayout mLayout;
+		vector<IDFlowRectNode> mNodes;
+		int mRoot;
+		vector<IDFlowRibbonBand> mBands;
+
+		int buildNode(const vector<size_t>& items) {
+			if (items.empty())
+				return -1;
+
+			const vector<IDFlowShape>& shapes = mLayout.Shapes;
+			vector<int> centers;
+			for (const size_t i : items)
+				centers.push_back(shapes[i].Bounds.x + shapes[i].Bounds.width / 2);
+			nth_element(centers.begin(), centers.begin() + centers.size() / 2, centers.end());
+
+			IDFlowRectNode node{ centers[centers.size() / 2], {}, {}, -1, -1 };
+			vector<size_t> before;
+			vector<size_t> after;
+			for (const size_t i : items) {
+				const Rect bounds = shapes[i].Bounds;
+				if (bounds.x + bounds.width <= node.Center)
+					before.push_back(i);
+				else if (bounds.x > node.Center)
+					after.push_back(i);
+				else
+					node.Items.push_back(i);
+			}
+
+			stable_sort(node.Items.begin(), node.Items.end(), [&](const size_t a, const size_t b) { return shapes[a].Bounds.y < shapes[b].Bounds.y; });
+			int bottom = numeric_limits<int>::min();
+			for (const size_t i : node.Items) {
+				bottom = max(bottom, shapes[i].Bounds.y + shapes[i].Bounds.height);
+				node.Bottoms.push_back(bottom);
+			}
+
+			const int index = static_cast<int>(mNodes.size());
+			mNodes.push_back(std::move(node));
+			const int beforeIndex = buildNode(before);
+			const int afterIndex = buildNode(after);
+			mNodes[index].Before = beforeIndex;
+			mNodes[index].After = afterIndex;
+			return index;
+		}
+
+		IDFlowRibbonBand buildBand(const double from, const double to, const vector<size_t>& ribbons) const {
+			const vector<IDFlowShape>& shapes = mLayout.Shapes;
+			const int left = static_cast<int>(ceil(min(from, to)));
+			const int right = static_cast<int>(floor(max(from, to)));
+
+			IDFlowRibbonBand band{ from, to, left, { 0 }, {} };
+			vector<Range> spans(ribbons.size());
+			vector<size_t> order(ribbons.size());
+			iota(order.begin(), order.end(), 0);
+			vector<pair<int, int>> open;
+			for (int x = left; x <= right; x++) {
+				// the same weights of the control points as the curves are drawn with
+				const double t = from == to ? 0 : (x - from) / (to - from);
+				const Vec4d weights(pow(1 - t, 3), 3 * t * pow(1 - t, 2), 3 * pow(t, 2) * (1 - t), pow(t, 3));
+				for (size_t k = 0, size = ribbons.size(); k < size; k++)
+					spans[k] = getRibbonRows(shapes[ribbons[k]], weights);
+
+				const auto byStart = [&](const size_t a, const size_t b) { return spans[a].start < spans[b].start; };
+				if (x == left)
+					sort(order.begin(), order.end(), byStart);
+				else
+					// two ribbons between the same columns cross at most once, so the order of the previous column is nearly sorted
+					for (size_t k = 1, size = order.size(); k < size; k++)
+						for (size_t j = k; j > 0 && byStart(order[j], order[j - 1]); j--)
+							swap(order[j], order[j - 1]);
+
+				// the ribbon on top only changes where a span starts or where the span on top ends; open spans are kept in a heap with the
+				// last drawn on top, and the ones already ended are dropped once they reach the top
+				band.Runs.push_back({ numeric_limits<int>::min(), -1 });
+				open.clear();
+				const auto addRun = [&](const int row) {
+					const int shape = open.empty() ? -1 : open.front().first;
+					if (shape != band.Runs.back().Shape)
+						band.Runs.push_back({ row, shape });
+				};
+				const auto closeSpans = [&](const int row) {
+					while (!open.empty() && open.front().second < row) {
+						pop_heap(open.begin(), open.end());
+						open.pop_back();
+					}
+				};
+				const auto closeTopSpans = [&](const int before) {
+					while (!open.empty() && open.front().second + 1 < before) {
+						const int row = open.front().second + 1;
+						closeSpans(row);
+						addRun(row);
+					}
+				};
+
+				for (size_t k = 0, size = order.size(); k < size;) {
+					const int row = spans[order[k]].start;
+					closeTopSpans(row);
+					closeSpans(row);
+					for (; k < size && spans[order[k]].start == row; k++) {
+						open.emplace_back(static_cast<int>(ribbons[order[k]]), spans[order[k]].end);
+						push_heap(open.begin(), open.end());
+					}
+					addRun(row);
+				}
+				closeTopSpans(numeric_limits<int>::max());
+				band.Columns.push_back(band.Runs.size());
+			}
+
+			return band;
+		}
+
+		static double getCurveRow(const Vec4d& weights, const double source, const double target) {
+			return weights[0] * source + weights[1] * source + weights[2] * target + weights[3] * target;
+		}
+
+		static Range getRibbonRows(const IDFlowShape& ribbon, const Vec4d& weights) {
+			// the rows of the vertical line the ribbon is drawn with at the column
+			const int top = cvRound(getCurveRow(weights, ribbon.Source.y, ribbon.Target.y));
+			const int bottom = cvRound(getCurveRow(weights, ribbon.Source.y + ribbon.SourceHeight - 1, ribbon.Target.y + ribbon.TargetHeight - 1));
+			return Range(min(top, bottom), max(top, bottom));
+		}
+	};
+
+	/**
+	 * @brief Inter-dimensional flow maker
+	 */
+	class IDFlowMaker {
+	public:
+		/**
+		 * @brief IDFlowMaker instance constructor
+		 * @param pParams Instance of IDFlowParams class used to create inter-dimensional flows
+		 */
+		explicit IDFlowMaker(const IDFlowParams& pParams) : mParams(pParams) {}
+
+		/**
+		 * @brief Create an inter-dimensional flow based on provided to this function parameters and the data from the IDFlowParams class
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param data A vector of pairs of strings which is used as a source of data
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		void createFlow(
+			Mat& image,
+			const vector<pair<string, string>>& data,
+			const string totalLabel,
+			const double countPerPixel) {
+
+			IDFlowAggregate aggregate;
+			for (const auto& p : data)
+				aggregate.add(p.first, p.second);
+
+			createFlow(image, aggregate, totalLabel, countPerPixel);
+		}
+
+		/**
+		 * @brief Create an inter-dimensional flow from two columns of a tabular data source (e.g. rapidcsv::Document) without copying its cells
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		template<typename TSource>
+		void createFlow(
+			Mat& image,
+			const TSource& source,
+			const size_t inColumn,
+			const size_t outColumn,
+			const string totalLabel,
+			const double countPerPixel) {
+
+			createFlow(image, aggregate(source, inColumn, outColumn), totalLabel, countPerPixel);
+		}
+
+		/**
+		 * @brief Count two columns of a tabular data source (e.g. rapidcsv::Document) in one pass. If the source provides GetCellView(column, row),
+		 *		  cells are not copied and the rows are split between Threads workers; the result does not depend on the number of workers.
+		 *		  If the source provides GetCount(row) (e.g. rapidcsv::GroupTable), each row is counted that many times
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @return Aggregated data of inter-dimensional flow
+		 */
+		template<typename TSource>
+		IDFlowAggregate aggregate(const TSource& source, const size_t inColumn, const size_t outColumn) {
+			return aggregateRows(source, { inColumn, outColumn }, IDFlowAggregate());
+		}
+
+		/**
+		 * @brief Create an inter-dimensional flow from aggregated data
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param aggregate Aggregated data of inter-dimensional flow
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		void createFlow(
+			Mat& image,
+			const IDFlowAggregate& aggregate,
+			const string totalLabel,
+			const double countPerPixel) {
+
+			drawLayout(image, layoutFlow(aggregate, totalLabel, countPerPixel));
+		}
+
+		/**
+		 * @brief Compute the figures of an inter-dimensional flow from aggregated data without drawing them, see createFlow
+		 * @param aggregate Aggregated data of inter-dimensional flow
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 * @return Layout of inter-dimensional flow
+		 */
+		IDFlowLayout layoutFlow(
+			const IDFlowAggregate& aggregate,
+			const string totalLabel,
+			double countPerPixel) {
+
+			if (aggregate.Total == 0)
+				throw length_error("Data can not be empty");
+			if (totalLabel.empty())
+				throw length_error("Total label can not be empty");
+			if (countPerPixel <= 0 && mParams.ImageHeight <= 0)
+				throw invalid_argument("Count per pixel must be greater than 0 unless the image height is fixed");
+
+			const Scalar rectangleColor = mParams.FigureColor;
+
+			vector<IDFlowGroup> inGroups;
+			vector<IDFlowGroup> outGroups;
+			reorder(inGroups, aggregate.Ins, mParams.InGroups, rectangleColor, mParams.MaxGroups, mParams.OtherLabel);
+			reorder(outGroups, aggregate.Outs, mParams.OutGroups, rectangleColor, mParams.MaxGroups, mParams.OtherLabel);
+
+			if (countPerPixel <= 0)
+				countPerPixel = fitCountPerPixel({ &inGroups, &outGroups }, aggregate.Total);
+
+			map<Scalar, double, ScalarCompare> inColorToTotalCount;
+			map<Scalar, double, ScalarCompare> outColorToTotalCount;
+
+			for (const IDFlowGroup value : inGroups)
+				inColorToTotalCount[value.Color] += value.Count;
+			for (const IDFlowGroup value : outGroups)
+				outColorToTotalCount[value.Color] += value.Count;
+
+			int imgWidth = mParams.ImageWidth;
+			int imgHeight = mParams.ImageHeight;
+
+			if (imgWidth <= 0)
+				imgWidth = 3 * mParams.FigureWidth + 2 * mParams.HorizontalSpacing + 2 * mParams.Padding;
+
+			// the image holds the tallest of the three columns, as in fitCountPerPixel; figures of the shorter ones are placed within it
+			const auto getColumnHeight = [&](const vector<IDFlowGroup>& groups) {
+				long long height = (static_cast<long long>(groups.size()) - 1) * mParams.VerticalSpacing + 2LL * mParams.Padding;
+				for (const IDFlowGroup& p : groups)
+					height += max(toPixels(p.Count, countPerPixel), MINIMUM_FIGURE_HEIGHT);
+				return height;
+			};
+			const int totalHeight = max(toPixels(aggregate.Total, countPerPixel), MINIMUM_FIGURE_HEIGHT);
+			const long long contentHeight = max({ getColumnHeight(inGroups), getColumnHeight(outGroups), totalHeight + 2LL * mParams.Padding });
+			checkPixels(contentHeight);
+
+			if (imgHeight <= 0)
+				imgHeight = static_cast<int>(contentHeight);
+
+			vector<IDFlowShape> shapes;
+
+			int verticalRectangleOffset = mParams.Padding;
+			int horizontalOffset = mParams.Padding;
+			int verticalCurveOffset = mParams.Padding;
+
+			for (size_t i = 0, size = inGroups.size(); i < size; i++) {
+				const auto p = inGroups[i];
+				const int initialHeight = toPixels(p.Count, countPerPixel);
+				const int height = max(initialHeight, MINIMUM_FIGURE_HEIGHT);
+				const int curveEndHeight = i == size - 1 ? (totalHeight + mParams.Padding - verticalCurveOffset) : initialHeight;
+				const Scalar recColor = applyAlpha(p.Color, mParams.BgColor, getAlpha(p.Count, inColorToTotalCount[p.Color]));
+
+				shapes.push_back(IDFlowShape(Rect(horizontalOffset, verticalRectangleOffset, mParams.FigureWidth, height), recColor, p.Name, formatCount(p.Count), p.Count));
+				shapes.push_back(IDFlowShape(Point2d(horizontalOffset + mParams.FigureWidth, verticalRectangleOffset), Point2d(horizontalOffset + mParams.FigureWidth + mParams.HorizontalSpacing, verticalCurveOffset), height, curveEndHeight, recColor, rectangleColor,
+					p.Name, formatCount(p.Count), p.Count));
+
+				verticalRectangleOffset += height + mParams.VerticalSpacing;
+				verticalCurveOffset += curveEndHeight;
+			}
+
+			verticalRectangleOffset = mParams.Padding;
+			horizontalOffset += mParams.FigureWidth + mParams.HorizontalSpacing;
+
+			shapes.push_back(IDFlowShape(Rect(horizontalOffset, verticalRectangleOffset, mParams.FigureWidth, totalHeight), rectangleColor, totalLabel, formatCount(aggregate.Total), aggregate.Total));
+
+			verticalRectangleOffset = mParams.Padding;
+			horizontalOffset += mParams.FigureWidth + mParams.HorizontalSpacing;
+			verticalCurveOffset = mParams.Padding;
+
+			for (size_t i = 0, size = outGroups.size(); i < size; i++) {
+				const auto p = outGroups[i];
+				const int initialHeight = toPixels(p.Count, countPerPixel);
+				const int height = max(initialHeight, MINIMUM_FIGURE_HEIGHT);
+				const int curveEndHeight = i == size - 1 ? (totalHeight + mParams.Padding - verticalCurveOffset) : initialHeight;
+				const Scalar recColor = applyAlpha(p.Color, mParams.BgColor, getAlpha(p.Count, outColorToTotalCount[p.Color]));
+
+				shapes.push_back(IDFlowShape(Rect(horizontalOffset, verticalRectangleOffset, mParams.FigureWidth, height), recColor, p.Name, formatCount(p.Count), p.Count));
+				shapes.push_back(IDFlowShape(Point2d(horizontalOffset, verticalRectangleOffset), Point2d(horizontalOffset - mParams.HorizontalSpacing, verticalCurveOffset), height, curveEndHeight, recColor, rectangleColor,
+					p.Name, formatCount(p.Count), p.Count));
+
+				verticalRectangleOffset += height + mParams.VerticalSpacing;
+				verticalCurveOffset += curveEndHeight;
+			}
+
+			return IDFlowLayout(imgWidth, imgHeight, mParams.BgColor, countPerPixel, std::move(shapes));
+		}
+
+		/**
+		 * @brief Create an inter-dimensional flow from two columns of a tabular data source (e.g. rapidcsv::Document), weighting each row
+		 *		  by the number in a third column. countPerPixel then applies to the sums of weights
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @param weightColumn Zero-based index of the column containing the weights of the rows, finite and not negative
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		template<typename TSource>
+		void createFlow(
+			Mat& image,
+			const TSource& source,
+			const size_t inColumn,
+			const size_t outColumn,
+			const size_t weightColumn,
+			const string totalLabel,
+			const double countPerPixel) {
+
+			createFlow(image, aggregate(source, inColumn, outColumn, weightColumn), totalLabel, countPerPixel);
+		}
+
+		/**
+		 * @brief Sum the weights of the values of two columns of a tabular data source (e.g. rapidcsv::Document) in one pass, the same way as aggregate.
+		 *		  Weights are parsed from a numeric column and replace the row counts
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @param weightColumn Zero-based index of the column containing the weights of the rows, finite and not negative
+		 * @return Aggregated data of inter-dimensional flow
+		 */
+		template<typename TSource>
+		IDFlowAggregate aggregate(const TSource& source, const size_t inColumn, const size_t outColumn, const size_t weightColumn) {
+			return aggregateRows(source, { inColumn, outColumn }, IDFlowAggregate(), static_cast<ptrdiff_t>(weightColumn));
+		}
+
+		/**
+		 * @brief Sum the weights of the values of two columns of a tabular data source (e.g. rapidcsv::Document), the same way as aggregate.
+		 *		  Weights come from a contiguous array, one per row, and replace the row counts; they are summed in blocks of rows
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @param weights Weights of the rows, finite and not negative
+		 * @return Aggregated data of inter-dimensional flow
+		 */
+		template<typename TSource>
+		IDFlowAggregate aggregate(const TSource& source, const size_t inColumn, const size_t outColumn, const span<const double> weights) {
+			return aggregateWeights(source, inColumn, outColumn, weights);
+		}
+
+		/**
+		 * @brief Sum the weights of the values of two columns of a tabular data source (e.g. rapidcsv::Document), the same way as aggregate.
+		 *		  Weights come from a contiguous array, one per row, and replace the row counts; they are summed in blocks of rows
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @param weights Integer weights of the rows, not negative and exact up to 2^53
+		 * @return Aggregated data of inter-dimensional flow
+		 */
+		template<typename TSource>
+		IDFlowAggregate aggregate(const TSource& source, const size_t inColumn, const size_t outColumn, const span<const int64_t> weights) {
+			return aggregateWeights(source, inColumn, outColumn, weights);
+		}
+
+		/**
+		 * @brief Create an inter-dimensional flow from values that are already encoded as small integer ids, e.g. dictionary-encoded columns
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param inIds Ids of the values on the left side of inter-dimensional flow, one per row
+		 * @param inNames Dictionary of the left side, inNames[id] is the value of the id
+		 * @param outIds Ids of the values on the right side of inter-dimensional flow, one per row
+		 * @param outNames Dictionary of the right side, outNames[id] is the value of the id
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		template<typename TId>
+		void createFlow(
+			Mat& image,
+			const span<const TId> inIds,
+			const vector<string>& inNames,
+			const span<const TId> outIds,
+			const vector<string>& outNames,
+			const string totalLabel,
+			const double countPerPixel) {
+
+			createFlow(image, aggregate(inIds, inNames, outIds, outNames), totalLabel, countPerPixel);
+		}
+
+		/**
+		 * @brief Count values that are already encoded as small integer ids. No strings are hashed: each side is counted directly into a histogram
+		 *		  indexed by id, using four interleaved sub-histograms so that consecutive rows with the same id do not wait for each other's updates.
+		 *		  The rows are split between Threads workers
+		 * @param inIds Ids of the values on the left side of inter-dimensional flow, one per row
+		 * @param inNames Dictionary of the left side, inNames[id] is the value of the id
+		 * @param outIds Ids of the values on the right side of inter-dimensional flow, one per row
+		 * @param outNames Dictionary of the right side, outNames[id] is the value of the id
+		 * @return Aggregated data of inter-dimensional flow
+		 */
+		template<typename TId>
+		IDFlowAggregate aggregate(const span<const TId> inIds, const vector<string>& inNames, const span<const TId> outIds, const vector<string>& outNames) {
+			static_assert(is_unsigned_v<TId>, "Ids must be of an unsigned integer type");
+
+			if (inIds.size() != outIds.size())
+				throw invalid_argument("Both sides must have one id per row");
+
+			const IDFlowDimension ins = countIds(inIds, inNames);
+			const IDFlowDimension outs = countIds(outIds, outNames);
+			return IDFlowAggregate(ins, outs, static_cast<double>(inIds.size()));
+		}
+
+		/**
+		 * @brief Create an inter-dimensional flow from approximate aggregated data. Groups are ordered by descending estimated count
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param sketch Approximate aggregated data of inter-dimensional flow
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		void createFlow(
+			Mat& image,
+			const IDFlowSketch& sketch,
+			const string totalLabel,
+			const double countPerPixel) {
+
+			createFlow(image, sketch.toAggregate(), totalLabel, countPerPixel);
+		}
+
+		/**
+		 * @brief Count the most frequent values of two columns of a tabular data source (e.g. rapidcsv::Document) in one pass with bounded memory,
+		 *		  the same way as aggregate. Unlike with aggregate, the result depends on Threads: the summaries of the workers are merged approximately,
+		 *		  so the monitored values, their counts and errors may differ, but every count stays within the errors reported for it
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @param capacity Maximum number of monitored values on each side
+		 * @return Approximate aggregated data of inter-dimensional flow
+		 */
+		template<typename TSource>
+		IDFlowSketch aggregateSketch(const TSource& source, const size_t inColumn, const size_t outColumn, const size_t capacity) {
+			return aggregateRows(source, { inColumn, outColumn }, IDFlowSketch(capacity));
+		}
+
+		/**
+		 * @brief Create an inter-dimensional flow from the rows in a sliding time window
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param window Aggregated data of inter-dimensional flow over a sliding time window
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		void createFlow(
+			Mat& image,
+			const IDFlowWindow& window,
+			const string totalLabel,
+			const double countPerPixel) {
+
+			createFlow(image, window.toAggregate(), totalLabel, countPerPixel);
+		}
+
+		/**
+		 * @brief Add the rows of a tabular data source (e.g. rapidcsv::Document) to a sliding time window, in the order of the rows
+		 * @param window Sliding time window to update
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param timeColumn Zero-based index of the column containing integer timestamps
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 */
+		template<typename TSource>
+		void updateWindow(IDFlowWindow& window, const TSource& source, const size_t timeColumn, const size_t inColumn, const size_t outColumn) {
+			string timeBuffer;
+			string inBuffer;
+			string outBuffer;
+			for (size_t i = 0, size = source.GetRowCount(); i < size; i++) {
+				const string_view time = getCell(source, timeColumn, i, timeBuffer);
+				int64_t value = 0;
+				const auto result = from_chars(time.data(), time.data() + time.size(), value);
+				if (result.ec != errc() || result.ptr != time.data() + time.size())
+					throw invalid_argument("Invalid timestamp: " + string(time));
+
+				window.add(value, getCell(source, inColumn, i, inBuffer), getCell(source, outColumn, i, outBuffer), getRowCount(source, i));
+			}
+		}
+
+		/**
+		 * @brief Create an inter-dimensional flow of pairs from two columns of a tabular data source (e.g. rapidcsv::Document)
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		template<typename TSource>
+		void createPairFlow(
+			Mat& image,
+			const TSource& source,
+			const size_t inColumn,
+			const size_t outColumn,
+			const double countPerPixel) {
+
+			createPairFlow(image, aggregatePairs(source, inColumn, outColumn), countPerPixel);
+		}
+
+		/**
+		 * @brief Count pairs of values of two columns of a tabular data source (e.g. rapidcsv::Document) in one pass, the same way as aggregate
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param inColumn Zero-based index of the column used for the left side of inter-dimensional flow
+		 * @param outColumn Zero-based index of the column used for the right side of inter-dimensional flow
+		 * @return Joint counts of inter-dimensional flow
+		 */
+		template<typename TSource>
+		IDFlowMatrix aggregatePairs(const TSource& source, const size_t inColumn, const size_t outColumn) {
+			return aggregateRows(source, { inColumn, outColumn }, IDFlowMatrix());
+		}
+
+		/**
+		 * @brief Create an inter-dimensional flow of pairs: the left and right groups are connected directly, by one ribbon per non-zero
+		 *		  joint count. Ribbons are stacked in the order of the groups on the other side
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param matrix Joint counts of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		void createPairFlow(
+			Mat& image,
+			const IDFlowMatrix& matrix,
+			const double countPerPixel) {
+
+			drawLayout(image, layoutPairFlow(matrix, countPerPixel));
+		}
+
+		/**
+		 * @brief Compute the figures of an inter-dimensional flow of pairs without drawing them, see createPairFlow
+		 * @param matrix Joint counts of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 * @return Layout of inter-dimensional flow
+		 */
+		IDFlowLayout layoutPairFlow(
+			const IDFlowMatrix& matrix,
+			const double countPerPixel) {
+
+			if (matrix.Total == 0)
+				throw length_error("Data can not be empty");
+			if (countPerPixel <= 0 && mParams.ImageHeight <= 0)
+				throw invalid_argument("Count per pixel must be greater than 0 unless the image height is fixed");
+
+			return layoutStages({ &matrix.Ins, &matrix.Outs }, { &matrix.Pairs }, countPerPixel);
+		}
+
+		/**
+		 * @brief Create a multi-stage inter-dimensional flow based on provided to this function parameters and the data from the IDFlowParams class
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param data A vector of rows of strings, one per stage, which is used as a source of data
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		void createStageFlow(
+			Mat& image,
+			const vector<vector<string>>& data,
+			const double countPerPixel) {
+
+			if (data.empty())
+				throw length_error("Data can not be empty");
+
+			IDFlowStages stages(data.front().size());
+			for (const vector<string>& row : data)
+				stages.add(row);
+
+			createStageFlow(image, stages, countPerPixel);
+		}
+
+		/**
+		 * @brief Create a multi-stage inter-dimensional flow from columns of a tabular data source (e.g. rapidcsv::Document)
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param columns Zero-based indices of the columns used for the stages of inter-dimensional flow, from left to right
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		template<typename TSource>
+		void createStageFlow(
+			Mat& image,
+			const TSource& source,
+			const vector<size_t>& columns,
+			const double countPerPixel) {
+
+			createStageFlow(image, aggregateStages(source, columns), countPerPixel);
+		}
+
+		/**
+		 * @brief Count the values of several columns of a tabular data source (e.g. rapidcsv::Document) and the pairs of values of adjacent columns
+		 *		  in one pass, the same way as aggregate
+		 * @param source Data source providing GetRowCount() and either GetCellView(column, row) or GetCell<string>(column, row)
+		 * @param columns Zero-based indices of the columns used for the stages of inter-dimensional flow, from left to right
+		 * @return Aggregated data of multi-stage inter-dimensional flow
+		 */
+		template<typename TSource>
+		IDFlowStages aggregateStages(const TSource& source, const vector<size_t>& columns) {
+			return aggregateRows(source, columns, IDFlowStages(columns.size()));
+		}
+
+		/**
+		 * @brief Create a multi-stage inter-dimensional flow: groups of adjacent stages are connected by one ribbon per non-zero joint count.
+		 *		  InGroups and OutGroups of the IDFlowParams class order and color the first and the last stage
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param stages Aggregated data of multi-stage inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 */
+		void createStageFlow(
+			Mat& image,
+			const IDFlowStages& stages,
+			const double countPerPixel) {
+
+			drawLayout(image, layoutStageFlow(stages, countPerPixel));
+		}
+
+		/**
+		 * @brief Compute the figures of a multi-stage inter-dimensional flow without drawing them, see createStageFlow
+		 * @param stages Aggregated data of multi-stage inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 * @return Layout of inter-dimensional flow
+		 */
+		IDFlowLayout layoutStageFlow(
+			const IDFlowStages& stages,
+			const double countPerPixel) {
+
+			if (stages.Total == 0)
+				throw length_error("Data can not be empty");
+			if (countPerPixel <= 0 && mParams.ImageHeight <= 0)
+				throw invalid_argument("Count per pixel must be greater than 0 unless the image height is fixed");
+
+			vector<const IDFlowDimension*> dimensions;
+			vector<const IDFlowPairs*> pairs;
+			for (const IDFlowDimension& stage : stages.Stages)
+				dimensions.push_back(&stage);
+			for (const IDFlowPairs& stagePairs : stages.Pairs)
+				pairs.push_back(&stagePairs);
+
+			return layoutStages(dimensions, pairs, countPerPixel);
+		}
+
+		/**
+		 * @brief Create inter-dimensional flows of many aggregates side by side on one image, e.g. one per hour, so that they can be compared
+		 * @param image Output matrix (image) containing the panels
+		 * @param aggregates Aggregated data of each panel
+		 * @param totalLabels Headers for the middle sections of the panels
+		 * @param columns Number of panels in a row of the grid
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles, shared by all panels.
+		 *		  0 fits the panel with the most data into a fixed ImageHeight
+		 */
+		void createGrid(
+			Mat& image,
+			const vector<IDFlowAggregate>& aggregates,
+			const vector<string>& totalLabels,
+			const int columns,
+			const double countPerPixel) {
+
+			drawGrid(image, layoutGrid(aggregates, totalLabels, countPerPixel), columns);
+		}
+
+		/**
+		 * @brief Compute the layouts of panels of a grid without drawing them. All panels share the order and colors of the groups, taken from the
+		 *		  data of all panels together, and the count per pixel. MaxGroups keeps the largest groups of all panels together and merges the rest
+		 *		  in every panel. ImageWidth and ImageHeight are the size of one panel
+		 * @param aggregates Aggregated data of each panel
+		 * @param totalLabels Headers for the middle sections of the panels
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles, shared by all panels.
+		 *		  0 fits the panel with the most data into a fixed ImageHeight
+		 * @return Layouts of the panels
+		 */
+		vector<IDFlowLayout> layoutGrid(
+			const vector<IDFlowAggregate>& aggregates,
+			const vector<string>& totalLabels,
+			double countPerPixel) {
+
+			if (aggregates.empty())
+				throw length_error("Data can not be empty");
+			if (aggregates.size() != totalLabels.size())
+				throw invalid_argument("Each panel must have a total label");
+			if (countPerPixel <= 0 && mParams.ImageHeight <= 0)
+				throw invalid_argument("Count per pixel must be greater than 0 unless the image height is fixed");
+
+			IDFlowAggregate all;
+			for (const IDFlowAggregate& aggregate : aggregates)
+				all.append(aggregate);
+
+			// groups are ordered and merged once for all panels, then pinned in that order in every panel
+			vector<IDFlowGroup> inGroups;
+			vector<IDFlowGroup> outGroups;
+			const vector<size_t> inPositions = reorder(inGroups, all.Ins, mParams.InGroups, mParams.FigureColor, mParams.MaxGroups, mParams.OtherLabel);
+			const vector<size_t> outPositions = reorder(outGroups, all.Outs, mParams.OutGroups, mParams.FigureColor, mParams.MaxGroups, mParams.OtherLabel);
+
+			IDFlowParams panelParams = mParams;
+			panelParams.InGroups = getOrder(inGroups);
+			panelParams.OutGroups = getOrder(outGroups);
+			panelParams.MaxGroups = 0;
+			IDFlowMaker panelMaker(panelParams);
+
+			vector<IDFlowAggregate> panels;
+			for (const IDFlowAggregate& aggregate : aggregates)
+				panels.push_back(IDFlowAggregate(mergeGroups(aggregate.Ins, all.Ins, inPositions, inGroups), mergeGroups(aggregate.Outs, all.Outs, outPositions, outGroups),
+					aggregate.Total));
+
+			if (countPerPixel <= 0)
+				for (size_t i = 0, size = panels.size(); i < size; i++)
+					countPerPixel = max(countPerPixel, panelMaker.layoutFlow(panels[i], totalLabels[i], 0).CountPerPixel);
+
+			vector<IDFlowLayout> layouts;
+			for (size_t i = 0, size = panels.size(); i < size; i++)
+				layouts.push_back(panelMaker.layoutFlow(panels[i], totalLabels[i], countPerPixel));
+			return layouts;
+		}
+
+		/**
+		 * @brief Draw panels side by side on one image, each panel straight into its own area. With Threads other than 1 the panels are drawn in parallel
+		 * @param image Output matrix (image) containing the panels
+		 * @param panels Layouts of the panels, e.g. from layoutGrid. Every cell of the grid is as large as the largest panel
+		 * @param columns Number of panels in a row of the grid
+		 */
+		void drawGrid(Mat& image, const vector<IDFlowLayout>& panels, const int columns) {
+			if (panels.empty())
+				throw length_error("Data can not be empty");
+			if (columns <= 0)
+				throw invalid_argument("Number of columns must be greater than 0");
+
+			int cellWidth = 0;
+			int cellHeight = 0;
+			for (const IDFlowLayout& panel : panels) {
+				cellWidth = max(cellWidth, panel.Width);
+				cellHeight = max(cellHeight, panel.Height);
+				prepareCurveWeights(panel.Shapes);
+				prepareTexts(panel.Shapes);
+			}
+
+			const int count = static_cast<int>(panels.size());
+			const int rows = (count + columns - 1) / columns;
+			if (static_cast<long long>(rows) * cellHeight > numeric_limits<int>::max() || static_cast<long long>(min(count, columns)) * cellWidth > numeric_limits<int>::max())
+				throw overflow_error("Grid exceeds the maximum image size");
+			image = Mat(rows * cellHeight, min(count, columns) * cellWidth, IMAGE_TYPE, mParams.BgColor);
+
+			const int threads = static_cast<int>(max(1, min(mParams.Threads == 0 ? getNumThreads() : mParams.Threads, count)));
+			vector<exception_ptr> errors(count);
+			parallel_for_(Range(0, count), [&](const Range& range) {
+				for (int i = range.start; i < range.end; i++) {
+					const IDFlowLayout& panel = panels[i];
+					const Rect cell((i % columns) * cellWidth, (i / columns) * cellHeight, panel.Width, panel.Height);
+					try {
+						drawArea(image(cell), panel, Rect(0, 0, panel.Width, panel.Height), panel.Shapes);
+					}
+					catch (...) {
+						errors[i] = current_exception();
+					}
+				}
+			}, threads);
+
+			for (const auto& error : errors)
+				if (error)
+					rethrow_exception(error);
+		}
+
+		/**
+		 * @brief Draw the figures of an inter-dimensional flow. With Threads other than 1 the image is split into horizontal bands drawn in parallel;
+		 *		  the result is the same as drawing on one thread
+		 * @param image Output matrix (image) containing the inter-dimensional flow
+		 * @param layout Layout of inter-dimensional flow
+		 */
+		void drawLayout(Mat& image, const IDFlowLayout& layout) {
+			image = Mat(layout.Height, layout.Width, IMAGE_TYPE, layout.BgColor);
+			prepareCurveWeights(layout.Shapes);
+			prepareTexts(layout.Shapes);
+
+			renderBands(image, [&](const Mat& target, const IDFlowClip& clip) {
+				for (const IDFlowShape& shape : layout.Shapes)
+					drawShape(target, shape, clip);
+			});
+		}
+
+		/**
+		 * @brief Redraw one area of an image previously drawn from a layout of the same size. The area is cleared and every figure crossing it
+		 *		  is drawn clipped to it, so the area ends up exactly as if the whole image was drawn from the layout
+		 * @param image Matrix (image) containing the inter-dimensional flow
+		 * @param layout Layout of inter-dimensional flow
+		 * @param area Area of the image to redraw
+		 */
+		void drawLayout(Mat& image, const IDFlowLayout& layout, Rect area) {
+			area &= Rect(0, 0, image.cols, image.rows);
+			if (area.empty())
+				return;
+
+			prepareCurveWeights(layout.Shapes);
+			prepareTexts(layout.Shapes);
+			drawArea(image(area), layout, area, layout.Shapes);
+		}
+
+		/**
+		 * @brief Draw figures over an image without clearing it, e.g. to put some of the figures of a layout in front of the others
+		 * @param image Matrix (image) containing the inter-dimensional flow
+		 * @param shapes Figures in the order they are drawn
+		 * @param area Area of the image the figures are clipped to
+		 */
+		void drawShapes(Mat& image, const vector<IDFlowShape>& shapes, Rect area) {
+			area &= Rect(0, 0, image.cols, image.rows);
+			if (area.empty())
+				return;
+
+			prepareCurveWeights(shapes);
+			prepareTexts(shapes);
+			drawClipped(image(area), area, shapes);
+		}
+
+		/**
+		 * @brief Draw one tile of an inter-dimensional flow without drawing the rest of the image
+		 * @param tile Output matrix (image) containing the tile
+		 * @param layout Layout of inter-dimensional flow
+		 * @param area Area of the image covered by the tile
+		 */
+		void drawTile(Mat& tile, const IDFlowLayout& layout, Rect area) {
+			area &= Rect(0, 0, layout.Width, layout.Height);
+			if (area.empty())
+				throw invalid_argument("Tile must overlap the image");
+
+			tile = Mat(area.height, area.width, IMAGE_TYPE);
+			prepareCurveWeights(layout.Shapes);
+			prepareTexts(layout.Shapes);
+			drawArea(tile, layout, area, layout.Shapes);
+		}
+
+		/**
+		 * @brief Draw one tile of an inter-dimensional flow from a part of its figures, e.g. the ones already known to cross the tile. The layout
+		 *		  must be prepared by prepareLayout first
+		 * @param tile Output matrix (image) containing the tile
+		 * @param layout Layout of inter-dimensional flow
+		 * @param area Area of the image covered by the tile
+		 * @param shapes Indices of the figures of the layout to draw, in drawing order
+		 */
+		void drawTile(Mat& tile, const IDFlowLayout& layout, Rect area, const vector<size_t>& shapes) {
+			area &= Rect(0, 0, layout.Width, layout.Height);
+			if (area.empty())
+				throw invalid_argument("Tile must overlap the image");
+
+			tile = Mat(area.height, area.width, IMAGE_TYPE, layout.BgColor);
+			for (const size_t i : shapes) {
+				const IDFlowShape& shape = layout.Shapes.at(i);
+				if (!(shape.Bounds & area).empty())
+					drawShape(tile, shape, IDFlowClip{ area.tl(), area });
+			}
+		}
+
+		/**
+		 * @brief Prepare everything that drawing the figures of a layout needs, so that many tiles can be drawn by drawTile without doing it
+		 *		  for each of them
+		 * @param layout Layout of inter-dimensional flow
+		 */
+		void prepareLayout(const IDFlowLayout& layout) {
+			prepareCurveWeights(layout.Shapes);
+			prepareTexts(layout.Shapes);
+		}
+
+		/**
+		 * @brief Draw an inter-dimensional flow tile by tile, row by row, so that no more than one tile is held in memory. Tiles on the right
+		 *		  and bottom edges are cut to the size of the image
+		 * @param layout Layout of inter-dimensional flow
+		 * @param tileSize Size of the tiles
+		 * @param callback Function receiving each tile and the area of the image it covers. The tile is reused for the next one, so it must
+		 *		  be copied to be kept
+		 */
+		void drawTiles(const IDFlowLayout& layout, const Size tileSize, const function<void(const Mat&, const Rect&)>& callback) {
+			if (tileSize.width <= 0 || tileSize.height <= 0)
+				throw invalid_argument("Tile size must be greater than 0");
+
+			Mat buffer(min(tileSize.height, layout.Height), min(tileSize.width, layout.Width), IMAGE_TYPE);
+			prepareCurveWeights(layout.Shapes);
+			prepareTexts(layout.Shapes);
+			vector<IDFlowShape> rowShapes;
+			for (int y = 0; y < layout.Height; y += tileSize.height) {
+				const Rect row(0, y, layout.Width, min(tileSize.height, layout.Height - y));
+				rowShapes.clear();
+				for (const IDFlowShape& shape : layout.Shapes)
+					if (!(shape.Bounds & row).empty())
+						rowShapes.push_back(shape);
+
+				for (int x = 0; x < layout.Width; x += tileSize.width) {
+					const Rect area(x, y, min(tileSize.width, layout.Width - x), row.height);
+					const Mat tile = buffer(Rect(0, 0, area.width, area.height));
+					drawArea(tile, layout, area, rowShapes);
+					callback(tile, area);
+				}
+			}
+		}
+
+		/**
+		 * @brief Write an inter-dimensional flow as an SVG image. Figures are written straight from the layout as vector shapes in drawing order:
+		 *		  rectangles with their labels as text, and ribbons as closed cubic Bezier paths filled with linear gradients. The size of the output
+		 *		  depends on the number of figures, not on the size of the image
+		 * @param output Output stream
+		 * @param layout Layout of inter-dimensional flow
+		 */
+		void writeSvg(ostream& output, const IDFlowLayout& layout) {
+			const int textHeight = getTextSize("0", mParams.Font, mParams.FontSize, 1, NULL).height;
+			const int offset = mParams.TextOffset;
+
+			output << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << layout.Width << "\" height=\"" << layout.Height
+				<< "\" viewBox=\"0 0 " << layout.Width << ' ' << layout.Height << "\">\n";
+			output << "<rect width=\"100%\" height=\"100%\" fill=\"" << formatColor(layout.BgColor) << "\"/>\n";
+			output << "<g font-family=\"sans-serif\" font-size=\"" << formatNumber(textHeight / SVG_CAP_HEIGHT) << "\">\n";
+
+			size_t gradient = 0;
+			for (const IDFlowShape& shape : layout.Shapes) {
+				if (shape.Ribbon) {
+					const Point2d p0 = shape.Source;
+					const Point2d p3 = shape.Target;
+					const double x1 = p0.x + (p3.x - p0.x) / 3;
+					const double x2 = p0.x + (p3.x - p0.x) * 2 / 3;
+					const double bottom0 = p0.y + shape.SourceHeight;
+					const double bottom3 = p3.y + shape.TargetHeight;
+
+					output << "<linearGradient id=\"r" << gradient << "\" gradientUnits=\"userSpaceOnUse\" x1=\"" << formatNumber(p0.x) << "\" y1=\"0\" x2=\""
+						<< formatNumber(p3.x) << "\" y2=\"0\"><stop offset=\"0\" stop-color=\"" << formatColor(shape.Fill) << "\"/><stop offset=\"1\" stop-color=\""
+						<< formatColor(shape.TargetFill) << "\"/></linearGradient>\n";
+					output << "<path d=\"M" << formatNumber(p0.x) << ' ' << formatNumber(p0.y)
+						<< "C" << formatNumber(x1) << ' ' << formatNumber(p0.y) << ' ' << formatNumber(x2) << ' ' << formatNumber(p3.y) << ' ' << formatNumber(p3.x) << ' ' << formatNumber(p3.y)
+						<< "L" << formatNumber(p3.x) << ' ' << formatNumber(bottom3)
+						<< "C" << formatNumber(x2) << ' ' << formatNumber(bottom3) << ' ' << formatNumber(x1) << ' ' << formatNumber(bottom0) << ' ' << formatNumber(p0.x) << ' ' << formatNumber(bottom0)
+						<< "Z\" fill=\"url(#r" << gradient << ")\"/>\n";
+					gradient++;
+				}
+				else {
+					const Rect bounds = shape.Bounds;
+					const string textColor = formatColor(getContrastColor(shape.Fill));
+
+					output << "<rect x=\"" << bounds.x << "\" y=\"" << bounds.y << "\" width=\"" << bounds.width << "\" height=\"" << bounds.height
+						<< "\" fill=\"" << formatColor(shape.Fill) << "\"/>\n";
+					output << "<text x=\"" << bounds.x + offset << "\" y=\"" << bounds.y + textHeight + offset << "\" fill=\"" << textColor << "\">"
+						<< escapeXml(shape.Label) << "</text>\n";
+					output << "<text x=\"" << bounds.x + bounds.width - offset << "\" y=\"" << bounds.y + bounds.height - offset - 2 << "\" fill=\"" << textColor
+						<< "\" text-anchor=\"end\">" << escapeXml(shape.Caption) << "</text>\n";
+				}
+			}
+
+			output << "</g>\n</svg>\n";
+		}
+
+	private:
+		static const int IMAGE_TYPE = CV_8UC3;
+		static constexpr int MINIMUM_FIGURE_HEIGHT = 20;
+		static constexpr double MINIMUM_ALPHA = 0.25;
+		static const size_t MINIMUM_ROWS_PER_THREAD = 16384;
+		static constexpr size_t WEIGHT_BLOCK_ROWS = 4096;
+		static const int FIT_ITERATIONS = 64;
+		static const int MINIMUM_ROWS_PER_BAND = 64;
+		static const int UNCLIPPED = numeric_limits<int>::max() / 2;
+		static constexpr double SVG_CAP_HEIGHT = 0.7;
+		static const size_t MAXIMUM_CACHED_TEXTS = 4096;
+
+		/**
+		 * @brief Text rendered once as an anti-aliased coverage mask, so that it can be blended into an image in any color. The text starts on
+		 *		  its baseline at (Margin, Margin + TextSize.height) of the mask
+		 */
+		struct IDFlowText {
+			Size TextSize;
+			int Margin;
+			Mat Mask;
+		};
+
+		IDFlowParams mParams;
+		unordered_map<int, vector<Vec4d>> mCurveWeights;
+		unordered_map<string, IDFlowText> mTexts;
+
+		class IDFlowGroup {
+		public:
+			string Name;
+			double Count;
+			Scalar Color;
+			explicit IDFlowGroup(string name, double count, Scalar color) {
+				Name = name;
+				Count = count;
+				Color = color;
+			}
+		};
+
+		struct ScalarCompare {
+			bool operator() (const Scalar& lhs, const Scalar& rhs) const {
+				return (lhs[0] + lhs[1] * 256 + lhs[2] * 256 * 256) < (rhs[0] + rhs[1] * 256 + rhs[2] * 256 * 256);
+			}
+		};
+
+		/**
+		 * @brief Part of an image drawn on its own, e.g. by one worker. The target matrix starts at Offset of the image and figures are clipped
+		 *		  to Area; the outer edges of the image are not clipped, so a figure exceeding the image fails the same way as without parts
+		 */
+		struct IDFlowClip {
+			Point Offset;
+			Rect Area;
+		};
+
+		void drawArea(Mat target, const IDFlowLayout& layout, const Rect area, const vector<IDFlowShape>& shapes) {
+			target.setTo(layout.BgColor);
+			drawClipped(target, area, shapes);
+		}
+
+		void drawClipped(const Mat& target, const Rect area, const vector<IDFlowShape>& shapes) {
+			for (const IDFlowShape& shape : shapes)
+				if (!(shape.Bounds & area).empty())
+					drawShape(target, shape, IDFlowClip{ area.tl(), area });
+		}
+
+		void drawShape(const Mat& target, const IDFlowShape& shape, const IDFlowClip& clip) {
+			if (shape.Ribbon)
+				drawFilledCurve(target, shape.Source, shape.Target, shape.SourceHeight, shape.TargetHeight, shape.Fill, shape.TargetFill,
+					mCurveWeights.at(getCurveLength(shape.Source, shape.Target)), clip);
+			else
+				drawRectangle(target, shape.Bounds.x, shape.Bounds.y, shape.Bounds.width, shape.Bounds.height, shape.Fill, getText(shape.Label), getText(shape.Caption), mParams.TextOffset, clip);
+		}
+
+		static void drawRectangle(const Mat& image, const int x, const int y, const int width, const int height, const Scalar bgColor, const IDFlowText& topLeftText, const IDFlowText& bottomRightText, const int offset,
+			const IDFlowClip& clip) {
+
+			const Rect visible = Rect(x, y, width, height) & clip.Area;
+			if (visible.empty())
+				return;
+
+			// only the visible part of the rectangle is drawn, with the texts shifted into it, so tall rectangles cost no more than the area they cover
+			Mat rect = image(Rect(visible.tl() - clip.Offset, visible.size()));
+			rect.setTo(bgColor);
+			const Point shift(visible.x - x, visible.y - y);
+
+			Scalar textColor = getContrastColor(bgColor);
+
+			blendText(rect, topLeftText, Point(offset, topLeftText.TextSize.height + offset) - shift, textColor);
+			blendText(rect, bottomRightText, Point(width - bottomRightText.TextSize.width - offset, height - offset - 2) - shift, textColor);
+		}
+
+		static void blendText(Mat image, const IDFlowText& text, const Point origin, const Scalar color) {
+			const Rect mask(origin.x - text.Margin, origin.y - text.Margin - text.TextSize.height, text.Mask.cols, text.Mask.rows);
+			const Rect visible = mask & Rect(0, 0, image.cols, image.rows);
+			for (int y = visible.y; y < visible.y + visible.height; y++) {
+				const uchar* coverage = text.Mask.ptr(y - mask.y);
+				Vec3b* pixel = image.ptr<Vec3b>(y);
+				for (int x = visible.x; x < visible.x + visible.width; x++) {
+					const double alpha = coverage[x - mask.x] / 255.0;
+					if (alpha > 0)
+						for (int c = 0; c < 3; c++)
+							pixel[x][c] = saturate_cast<uchar>(pixel[x][c] + (color[c] - pixel[x][c]) * alpha);
+				}
+			}
+		}
+
+		void prepareTexts(const vector<IDFlowShape>& shapes) {
+			// labels and captions are rendered once and blended in the color of every rectangle they are drawn on; once the cache is full it
+			// starts over, and texts that do not fit are rendered each time they are drawn
+			if (mTexts.size() >= MAXIMUM_CACHED_TEXTS)
+				mTexts.clear();
+			for (const IDFlowShape& shape : shapes)
+				if (!shape.Ribbon)
+					for (const string* text : { &shape.Label, &shape.Caption })
+						if (mTexts.size() < MAXIMUM_CACHED_TEXTS && mTexts.count(*text) == 0)
+							mTexts.emplace(*text, renderText(*text));
+		}
+
+		IDFlowText getText(const string& text) {
+			const auto cached = mTexts.find(text);
+			return cached == mTexts.end() ? renderText(text) : cached->second;
+		}
+
+		IDFlowText renderText(const string& text) {
+			int baseline = 0;
+			const Size size = getTextSize(text, mParams.Font, mParams.FontSize, 1, &baseline);
+			IDFlowText rendered{ size, size.height, Mat(3 * size.height + baseline, size.width + 2 * size.height, CV_8UC1, Scalar(0)) };
+			putText(rendered.Mask, text, Point(rendered.Margin, rendered.Margin + size.height), mParams.Font, mParams.FontSize, Scalar(255), 1, LINE_AA);
+			return rendered;
+		}
+
+		static int getCurveLength(const Point2d p0, const Point2d p3) {
+			return static_cast<int>(abs(p3.x - p0.x));
+		}
+
+		void prepareCurveWeights(const vector<IDFlowShape>& shapes) {
+			// the weights of the control points along a curve only depend on its length, so they are computed once per length
+			for (const IDFlowShape& shape : shapes) {
+				const int l = shape.Ribbon ? getCurveLength(shape.Source, shape.Target) : -1;
+				if (l < 0 || mCurveWeights.count(l) != 0)
+					continue;
+
+				vector<Vec4d> weights;
+				for (double i = 0; i <= l; i++) {
+					const double t = i / l;
+					weights.push_back(Vec4d(pow(1 - t, 3), 3 * t * pow(1 - t, 2), 3 * pow(t, 2) * (1 - t), pow(t, 3)));
+				}
+				mCurveWeights.emplace(l, std::move(weights));
+			}
+		}
+
+		static void getCurvePoints(vector<Point2d>& points, const Point2d p0, const Point2d p3, const vector<Vec4d>& weights) {
+			const Point2d p1(p0.x + (p3.x - p0.x) / 3, p0.y);
+			const Point2d p2(p0.x + (p3.x - p0.x) * 2 / 3, p3.y);
+
+			for (const Vec4d& w : weights) {
+				auto x = w[0] * p0.x + w[1] * p1.x + w[2] * p2.x + w[3] * p3.x;
+				auto y = w[0] * p0.y + w[1] * p1.y + w[2] * p2.y + w[3] * p3.y;
+				points.push_back(Point2d(x, y));
+			}
+		}
+
+		static void drawFilledCurve(const Mat& img, const Point2d p0, const Point2d p3, const int leftHeight, const int rightHeight, const Scalar startColor, const Scalar endColor,
+			const vector<Vec4d>& weights, const IDFlowClip& clip) {
+
+			// the curves stay between the heights of their ends, so the ribbons outside of the clipped area can be skipped
+			if (max(p0.y + leftHeight, p3.y + rightHeight) < clip.Area.y || min(p0.y, p3.y) > clip.Area.y + clip.Area.height)
+				return;
+
+			vector<Point2d> topPoints;
+			vector<Point2d> bottomPoints;
+
+			getCurvePoints(topPoints, p0, p3, weights);
+			getCurvePoints(bottomPoints, Point2d(p0.x, p0.y + leftHeight - 1), Point2d(p3.x, p3.y + rightHeight - 1), weights);
+
+			int size = topPoints.size();
+
+			for (size_t i = 0; i < size; i++)
+				line(img, Point(topPoints[i]) - clip.Offset, Point(bottomPoints[i]) - clip.Offset, applyAlpha(startColor, endColor, 1 - ((double)i / (size - 1))));
+		}
+
+		struct IDFlowColumn {
+			vector<IDFlowGroup> Groups;
+			vector<size_t> Positions;
+			vector<int> Tops;
+			vector<int> Heights;
+			vector<Scalar> Colors;
+		};
+
+		IDFlowLayout layoutStages(const vector<const IDFlowDimension*>& stages, const vector<const IDFlowPairs*>& pairs, double countPerPixel) {
+			const Scalar rectangleColor = mParams.FigureColor;
+			const size_t stageCount = stages.size();
+
+			vector<IDFlowColumn> columns(stageCount);
+			long long bottom = 0;
+
+			for (size_t s = 0; s < stageCount; s++) {
+				IDFlowColumn& column = columns[s];
+				const vector<pair<string, Scalar>> order = s == 0 ? mParams.InGroups : s == stageCount - 1 ? mParams.OutGroups : vector<pair<string, Scalar>>();
+				column.Positions = reorder(column.Groups, *stages[s], order, rectangleColor, mParams.MaxGroups, mParams.OtherLabel);
+			}
+
+			if (countPerPixel <= 0) {
+				vector<const vector<IDFlowGroup>*> groups;
+				for (const IDFlowColumn& column : columns)
+					groups.push_back(&column.Groups);
+				countPerPixel = fitCountPerPixel(groups, 0);
+			}
+
+			for (IDFlowColumn& column : columns) {
+				map<Scalar, double, ScalarCompare> colorToTotalCount;
+				for (const IDFlowGroup value : column.Groups)
+					colorToTotalCount[value.Color] += value.Count;
+
+				for (size_t i = 0, size = column.Groups.size(); i < size; i++) {
+					const auto& p = column.Groups[i];
+					column.Tops.push_back(i == 0 ? mParams.Padding : checkPixels(static_cast<long long>(column.Tops[i - 1]) + column.Heights[i - 1] + mParams.VerticalSpacing));
+					column.Heights.push_back(max(toPixels(p.Count, countPerPixel), MINIMUM_FIGURE_HEIGHT));
+					column.Colors.push_back(applyAlpha(p.Color, mParams.BgColor, getAlpha(p.Count, colorToTotalCount[p.Color])));
+				}
+
+				if (!column.Groups.empty())
+					bottom = max(bottom, static_cast<long long>(column.Tops.back()) + column.Heights.back());
+			}
+			checkPixels(bottom + mParams.Padding);
+
+			int imgWidth = mParams.ImageWidth;
+			int imgHeight = mParams.ImageHeight;
+
+			if (imgWidth <= 0)
+				imgWidth = stageCount * mParams.FigureWidth + (stageCount - 1) * mParams.HorizontalSpacing + 2 * mParams.Padding;
+
+			if (imgHeight <= 0)
+				imgHeight = static_cast<int>(bottom + mParams.Padding);
+
+			vector<IDFlowShape> shapes;
+			for (size_t s = 0; s + 1 < stageCount; s++) {
+				const IDFlowColumn& in = columns[s];
+				const IDFlowColumn& out = columns[s + 1];
+				const int inOffset = mParams.Padding + s * (mParams.FigureWidth + mParams.HorizontalSpacing);
+				const int outOffset = inOffset + mParams.FigureWidth + mParams.HorizontalSpacing;
+
+				// merge the pairs of groups sharing a rectangle, e.g. the ones merged by MaxGroups
+				IDFlowPairs groupPairs;
+				for (size_t i = 0, size = pairs[s]->size(); i < size; i++)
+					groupPairs.add(in.Positions[pairs[s]->InIds[i]], out.Positions[pairs[s]->OutIds[i]], pairs[s]->Counts[i]);
+
+				const vector<size_t>& pairInIds = groupPairs.InIds;
+				const vector<size_t>& pairOutIds = groupPairs.OutIds;
+				const vector<double>& pairCounts = groupPairs.Counts;
+				const size_t pairCount = pairCounts.size();
+
+				vector<int> inRibbonTops(pairCount);
+				vector<int> inRibbonHeights(pairCount);
+				vector<int> outRibbonTops(pairCount);
+				vector<int> outRibbonHeights(pairCount);
+
+				stackRibbons(inRibbonTops, inRibbonHeights, pairInIds, pairOutIds, pairCounts, in.Tops, countPerPixel);
+				stackRibbons(outRibbonTops, outRibbonHeights, pairOutIds, pairInIds, pairCounts, out.Tops, countPerPixel);
+
+				for (size_t i = 0; i < pairCount; i++) {
+					if (inRibbonHeights[i] <= 0 && outRibbonHeights[i] <= 0)
+						continue;
+
+					shapes.push_back(IDFlowShape(Point2d(inOffset + mParams.FigureWidth, inRibbonTops[i]), Point2d(outOffset, outRibbonTops[i]),
+						max(inRibbonHeights[i], 1), max(outRibbonHeights[i], 1), in.Colors[pairInIds[i]], out.Colors[pairOutIds[i]],
+						in.Groups[pairInIds[i]].Name + " -> " + out.Groups[pairOutIds[i]].Name, formatCount(pairCounts[i]), pairCounts[i]));
+				}
+			}
+
+			for (size_t s = 0; s < stageCount; s++) {
+				const IDFlowColumn& column = columns[s];
+				const int horizontalOffset = mParams.Padding + s * (mParams.FigureWidth + mParams.HorizontalSpacing);
+				for (size_t i = 0, size = column.Groups.size(); i < size; i++) {
+					const auto& p = column.Groups[i];
+					shapes.push_back(IDFlowShape(Rect(horizontalOffset, column.Tops[i], mParams.FigureWidth, column.Heights[i]), column.Colors[i], p.Name, formatCount(p.Count), p.Count));
+				}
+			}
+
+			return IDFlowLayout(imgWidth, imgHeight, mParams.BgColor, countPerPixel, std::move(shapes));
+		}
+
+		template<typename TDraw>
+		void renderBands(Mat& image, TDraw draw) {
+			const int threads = static_cast<int>(max(1, min(mParams.Threads == 0 ? getNumThreads() : mParams.Threads, image.rows / MINIMUM_ROWS_PER_BAND)));
+			if (threads == 1) {
+				draw(image, IDFlowClip{ Point(0, 0), Rect(-UNCLIPPED, -UNCLIPPED, 2 * UNCLIPPED, 2 * UNCLIPPED) });
+				return;
+			}
+
+			vector<exception_ptr> errors(threads);
+			parallel_for_(Range(0, threads), [&](const Range& range) {
+				for (int t = range.start; t < range.end; t++) {
+					const int top = image.rows * t / threads;
+					const int bottom = image.rows * (t + 1) / threads;
+					const int clipTop = t == 0 ? -UNCLIPPED : top;
+					const int clipBottom = t == threads - 1 ? UNCLIPPED : bottom;
+					try {
+						draw(image.rowRange(top, bottom), IDFlowClip{ Point(0, top), Rect(-UNCLIPPED, clipTop, 2 * UNCLIPPED, clipBottom - clipTop) });
+					}
+					catch (...) {
+						errors[t] = current_exception();
+					}
+				}
+			}, threads);
+
+			for (const auto& error : errors)
+				if (error)
+					rethrow_exception(error);
+		}
+
+		template<typename TResult, typename TAddRows>
+		TResult aggregateParts(const size_t rowCount, const int threads, const TResult& empty, TAddRows addRows) {
+			vector<TResult> parts(threads, empty);
+			vector<exception_ptr> errors(threads);
+
+			auto aggregatePart = [&](const int t) {
+				try {
+					addRows(parts[t], rowCount * t / threads, rowCount * (t + 1) / threads);
+				}
+				catch (...) {
+					errors[t] = current_exception();
+				}
+			};
+
+			if (threads == 1)
+				aggregatePart(0);
+			else
+				parallel_for_(Range(0, threads), [&](const Range& range) {
+					for (int t = range.start; t < range.end; t++)
+						aggregatePart(t);
+				}, threads);
+
+			for (const auto& error : errors)
+				if (error)
+					rethrow_exception(error);
+
+			for (int t = 1; t < threads; t++)
+				parts[0].append(parts[t]);
+
+			return std::move(parts[0]);
+		}
+
+		template<typename TResult, typename TSource>
+		TResult aggregateRows(const TSource& source, const vector<size_t>& columns, const TResult& empty, const ptrdiff_t weightColumn = -1) {
+			const size_t rowCount = source.GetRowCount();
+			const int threads = requires { source.GetCellView(size_t(), size_t()); } ? getThreadCount(rowCount) : 1;
+
+			return aggregateParts(rowCount, threads, empty, [&](TResult& result, const size_t begin, const size_t end) {
+				vector<string> buffers(columns.size() + 1);
+				vector<string_view> values(columns.size());
+				for (size_t i = begin; i < end; i++) {
+					for (size_t c = 0, size = columns.size(); c < size; c++)
+						values[c] = getCell(source, columns[c], i, buffers[c]);
+
+					const double count = weightColumn < 0 ? getRowCount(source, i) : parseWeight(getCell(source, weightColumn, i, buffers.back()));
+					if constexpr (requires { result.add(span<const string_view>(values), count); })
+						result.add(span<const string_view>(values), count);
+					else
+						result.add(values[0], values[1], count);
+				}
+			});
+		}
+
+		template<typename TId>
+		IDFlowDimension countIds(const span<const TId> ids, const vector<string>& names) {
+			const size_t nameCount = names.size();
+			if (!ids.empty() && *max_element(ids.begin(), ids.end()) >= nameCount)
+				throw invalid_argument("Id is out of range of the dictionary");
+
+			const size_t rowCount = ids.size();
+			const int threads = getThreadCount(rowCount);
+			vector<vector<uint64_t>> parts(threads);
+
+			auto countPart = [&](const int t) {
+				vector<uint64_t> histograms(4 * nameCount, 0);
+				uint64_t* const first = histograms.data();
+				uint64_t* const second = first + nameCount;
+				uint64_t* const third = second + nameCount;
+				uint64_t* const fourth = third + nameCount;
+
+				const size_t end = rowCount * (t + 1) / threads;
+				size_t i = rowCount * t / threads;
+				for (; i + 4 <= end; i += 4) {
+					first[ids[i]]++;
+					second[ids[i + 1]]++;
+					third[ids[i + 2]]++;
+					fourth[ids[i + 3]]++;
+				}
+				for (; i < end; i++)
+					first[ids[i]]++;
+
+				for (size_t id = 0; id < nameCount; id++)
+					first[id] += second[id] + third[id] + fourth[id];
+				histograms.resize(nameCount);
+				parts[t] = std::move(histograms);
+			};
+
+			if (threads == 1)
+				countPart(0);
+			else
+				parallel_for_(Range(0, threads), [&](const Range& range) {
+					for (int t = range.start; t < range.end; t++)
+						countPart(t);
+				}, threads);
+
+			for (int t = 1; t < threads; t++)
+				for (size_t id = 0; id < nameCount; id++)
+					parts[0][id] += parts[t][id];
+
+			IDFlowDimension result;
+			for (size_t id = 0; id < nameCount; id++)
+				if (parts[0][id] > 0)
+					result.add(names[id], static_cast<double>(parts[0][id]));
+			return result;
+		}
+
+		template<typename TSource, typename TWeight>
+		IDFlowAggregate aggregateWeights(const TSource& source, const size_t inColumn, const size_t outColumn, const span<const TWeight> weights) {
+			const size_t rowCount = source.GetRowCount();
+			if (weights.size() != rowCount)
+				throw invalid_argument("Weights must have one value per row");
+			if (!all_of(weights.begin(), weights.end(), [](const TWeight weight) { return isWeight(static_cast<double>(weight)); }))
+				throw invalid_argument("Weights must be finite and not negative");
+
+			if constexpr (requires { source.GetCellView(inColumn, size_t()); }) {
+				return aggregateParts(rowCount, getThreadCount(rowCount), IDFlowAggregate(), [&](IDFlowAggregate& result, const size_t begin, const size_t end) {
+					vector<string_view> ins(WEIGHT_BLOCK_ROWS);
+					vector<string_view> outs(WEIGHT_BLOCK_ROWS);
+					for (size_t block = begin; block < end; block += WEIGHT_BLOCK_ROWS) {
+						const size_t size = min(WEIGHT_BLOCK_ROWS, end - block);
+						for (size_t i = 0; i < size; i++) {
+							ins[i] = source.GetCellView(inColumn, block + i);
+							outs[i] = source.GetCellView(outColumn, block + i);
+						}
+						result.add(span<const string_view>(ins.data(), size), span<const string_view>(outs.data(), size), weights.subspan(block, size));
+					}
+				});
+			}
+			else {
+				IDFlowAggregate result;
+				for (size_t i = 0; i < rowCount; i++)
+					result.add(source.template GetCell<string>(inColumn, i), source.template GetCell<string>(outColumn, i), static_cast<double>(weights[i]));
+				return result;
+			}
+		}
+
+		double fitCountPerPixel(const vector<const vector<IDFlowGroup>*>& columns, const double total) {
+			const double imageHeight = mParams.ImageHeight;
+
+			auto getHeight = [&](const double countPerPixel) {
+				double height = max(floor(total / countPerPixel), static_cast<double>(MINIMUM_FIGURE_HEIGHT)) + 2.0 * mParams.Padding;
+				for (const vector<IDFlowGroup>* groups : columns) {
+					if (groups->empty())
+						continue;
+					double columnHeight = (groups->size() - 1.0) * mParams.VerticalSpacing + 2.0 * mParams.Padding;
+					for (const IDFlowGroup& p : *groups)
+						columnHeight += max(floor(p.Count / countPerPixel), static_cast<double>(MINIMUM_FIGURE_HEIGHT));
+					height = max(height, columnHeight);
+				}
+				return height;
+			};
+
+			double largest = total;
+			for (const vector<IDFlowGroup>* groups : columns) {
+				double sum = 0;
+				for (const IDFlowGroup& p : *groups)
+					sum += p.Count;
+				largest = max(largest, sum);
+			}
+
+			// At this scale every figure is clamped to the minimum height, so no larger count per pixel can fit more
+			double high = largest + 1;
+			if (getHeight(high) > imageHeight)
+				throw length_error("Groups do not fit into the image height");
+
+			double low = high;
+			while (getHeight(low) <= imageHeight)
+				low /= 2;
+
+			for (int i = 0; i < FIT_ITERATIONS; i++) {
+				const double middle = (low + high) / 2;
+				if (getHeight(middle) <= imageHeight)
+					high = middle;
+				else
+					low = middle;
+			}
+			return high;
+		}
+
+		static int toPixels(const double count, const double countPerPixel) {
+			const double pixels = count / countPerPixel;
+			if (!(pixels < numeric_limits<int>::max()))
+				throw overflow_error("Figure height exceeds the maximum image size, count per pixel is too small");
+			return static_cast<int>(pixels);
+		}
+
+		static int checkPixels(const long long pixels) {
+			if (pixels > numeric_limits<int>::max())
+				throw overflow_error("Image height exceeds the maximum image size, count per pixel is too small");
+			return static_cast<int>(pixels);
+		}
+
+		static bool isWeight(const double weight) {
+			// a negative or non-finite weight would make a group larger than the total and turn the ribbons inside out
+			return isfinite(weight) && weight >= 0;
+		}
+
+		static double parseWeight(const string_view value) {
+			double weight = 0;
+			const auto result = from_chars(value.data(), value.data() + value.size(), weight);
+			if (result.ec != errc() || result.ptr != value.data() + value.size() || !isWeight(weight))
+				throw invalid_argument("Invalid weight: " + string(value));
+			return weight;
+		}
+
+		static string formatNumber(const double value) {
+			char buffer[32];
+			char* end = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::fixed, 2).ptr;
+			while (end[-1] == '0')
+				end--;
+			if (end[-1] == '.')
+				end--;
+			return string(buffer, end);
+		}
+
+		static string formatColor(const Scalar& color) {
+			static const char DIGITS[] = "0123456789abcdef";
+			string result = "#";
+			for (int channel = 2; channel >= 0; channel--) {
+				const uchar value = saturate_cast<uchar>(color[channel]);
+				result += DIGITS[value >> 4];
+				result += DIGITS[value & 15];
+			}
+			return result;
+		}
+
+		static string escapeXml(const string& text) {
+			string result;
+			result.reserve(text.size());
+			for (const char c : text) {
+				switch (c) {
+				case '&': result += "&amp;"; break;
+				case '<': result += "&lt;"; break;
+				case '>': result += "&gt;"; break;
+				case '"': result += "&quot;"; break;
+				default: result += c;
+				}
+			}
+			return result;
+		}
+
+		static string formatCount(const double count) {
+			if (count == floor(count) && abs(count) < 1e18)
+				return to_string(static_cast<long long>(count));
+
+			ostringstream stream;
+			stream << fixed << setprecision(2) << count;
+			return stream.str();
+		}
+
+		template<typename TSource>
+		static string_view getCell(const TSource& source, const size_t column, const size_t row, string& buffer) {
+			if constexpr (requires { source.GetCellView(column, row); })
+				return source.GetCellView(column, row);
+			else
+				return buffer = source.template GetCell<string>(column, row);
+		}
+
+		static void stackRibbons(vector<int>& tops, vector<int>& heights, const vector<size_t>& groups, const vector<size_t>& otherGroups, const vector<double>& counts,
+			const vector<int>& groupTops, const double countPerPixel) {
+
+			vector<size_t> pairs(counts.size());
+			for (size_t i = 0, size = pairs.size(); i < size; i++)
+				pairs[i] = i;
+			sort(pairs.begin(), pairs.end(), [&](size_t a, size_t b) {
+				return groups[a] != groups[b] ? groups[a] < groups[b] : otherGroups[a] < otherGroups[b];
+			});
+
+			size_t group = SIZE_MAX;
+			double stacked = 0;
+			for (const size_t i : pairs) {
+				if (groups[i] != group) {
+					group = groups[i];
+					stacked = 0;
+				}
+				const int top = toPixels(stacked, countPerPixel);
+				stacked += counts[i];
+				tops[i] = groupTops[group] + top;
+				heights[i] = toPixels(stacked, countPerPixel) - top;
+			}
+		}
+
+		static vector<size_t> reorder(vector<IDFlowGroup>& result, const IDFlowDimension& source, const vector<pair<string, Scalar>> order, const Scalar defaultColor,
+			const size_t maxGroups, const string& otherLabel) {
+
+			const vector<string>& names = source.Names;
+			const vector<double>& counts = source.Counts;
+
+			vector<ptrdiff_t> idToOrder(names.size());
+			map<string, Scalar> nameToColor;
+
+			for (const pair<string, Scalar>& value : order)
+				nameToColor[value.first] = value.second;
+
+			for (size_t i = 0, size = names.size(); i < size; i++)
+				idToOrder[i] = i;
+
+			for (size_t i = 0, size = order.size(); i < size; i++)
+			{
+				const ptrdiff_t id = source.find(order[i].first);
+				if (id >= 0 && idToOrder[id] >= 0)
+					idToOrder[id] = static_cast<ptrdiff_t>(i) - static_cast<ptrdiff_t>(size);
+			}
+
+			vector<size_t> ids;
+			vector<size_t> unpinnedIds;
+			for (size_t i = 0, size = names.size(); i < size; i++)
+				(idToOrder[i] < 0 ? ids : unpinnedIds).push_back(i);
+
+			vector<size_t> otherIds;
+			if (maxGroups > 0 && unpinnedIds.size() > maxGroups) {
+				nth_element(unpinnedIds.begin(), unpinnedIds.begin() + maxGroups, unpinnedIds.end(),
+					[&counts](size_t a, size_t b) { return counts[a] != counts[b] ? counts[a] > counts[b] : a < b; });
+				otherIds.assign(unpinnedIds.begin() + maxGroups, unpinnedIds.end());
+				unpinnedIds.resize(maxGroups);
+			}
+
+			ids.insert(ids.end(), unpinnedIds.begin(), unpinnedIds.end());
+			sort(ids.begin(), ids.end(), [&idToOrder](size_t a, size_t b) { return idToOrder[a] < idToOrder[b]; });
+
+			vector<size_t> positions(names.size());
+			for (const size_t id : ids) {
+				positions[id] = result.size();
+				result.push_back(IDFlowGroup(names[id], counts[id], nameToColor.contains(names[id]) ? nameToColor[names[id]] : defaultColor));
+			}
+
+			if (!otherIds.empty()) {
+				double otherCount = 0;
+				for (const size_t id : otherIds) {
+					positions[id] = result.size();
+					otherCount += counts[id];
+				}
+				result.push_back(IDFlowGroup(otherLabel, otherCount, defaultColor));
+			}
+			return positions;
+		}
+
+		static vector<pair<string, Scalar>> getOrder(const vector<IDFlowGroup>& groups) {
+			vector<pair<string, Scalar>> order;
+			for (const IDFlowGroup& group : groups)
+				order.push_back({ group.Name, group.Color });
+			return order;
+		}
+
+		static IDFlowDimension mergeGroups(const IDFlowDimension& source, const IDFlowDimension& all, const vector<size_t>& positions, const vector<IDFlowGroup>& groups) {
+			const vector<string>& names = source.Names;
+			const vector<double>& counts = source.Counts;
+
+			vector<double> groupCounts(groups.size());
+			for (size_t i = 0, size = names.size(); i < size; i++)
+				groupCounts[positions[all.find(names[i])]] += counts[i];
+
+			IDFlowDimension result;
+			for (size_t i = 0, size = groups.size(); i < size; i++)
+				if (groupCounts[i] > 0)
+					result.add(groups[i].Name, groupCounts[i]);
+			return result;
+		}
+
+		template<typename TSource>
+		static double getRowCount(const TSource& source, const size_t row) {
+			if constexpr (requires { source.GetCount(row); })
+				return static_cast<double>(source.GetCount(row));
+			else
+				return 1;
+		}
+
+		int getThreadCount(const size_t rowCount) {
+			const int threads = mParams.Threads == 0 ? getNumThreads() : mParams.Threads;
+			return static_cast<int>(max<size_t>(1, min<size_t>(threads, rowCount / MINIMUM_ROWS_PER_THREAD)));
+		}
+
+		static double getAlpha(double count, double totalCount) {
+			return ((1 - MINIMUM_ALPHA) * count / totalCount) + MINIMUM_ALPHA;
+		}
+
+		static Scalar applyAlpha(Scalar fgColor, Scalar bgColor, double alpha) {
+			Scalar result;
+
+			for (size_t i = 0; i <= 2; i++)
+				result[i] = alpha * fgColor[i] + (1 - alpha) * bgColor[i];
+
+			return result;
 		}
 
 		static Scalar getContrastColor(Scalar color) {
@@ -586,4 +3786,839 @@ namespace idflow {
 			return luma > 0.5 ? COLOR_BLACK : COLOR_WHITE;
 		}
 	};
+
+	/**
+	 * @brief Keeps the last image of an inter-dimensional flow and redraws only the parts of it changed by a new layout
+	 */
+	class IDFlowRenderer {
+	public:
+		/**
+		 * @brief IDFlowRenderer instance constructor
+		 * @param pParams Instance of IDFlowParams class used to create inter-dimensional flows
+		 */
+		explicit IDFlowRenderer(const IDFlowParams& pParams) : mMaker(pParams) {}
+
+		/**
+		 * @brief Update the image to a new layout. Figures are compared with the previous layout in drawing order; the areas covered by
+		 *		  the changed figures, before and after the change, are cleared and redrawn with every figure crossing them. The image is drawn
+		 *		  from scratch on the first call and whenever its size or background changes
+		 * @param layout New layout of inter-dimensional flow, e.g. from IDFlowMaker::layoutFlow
+		 * @return Non-overlapping areas of the image that were redrawn
+		 */
+		const vector<Rect>& render(const IDFlowLayout& layout) {
+			mDirtyRects.clear();
+
+			if (mImage.empty() || layout.Width != mLayout.Width || layout.Height != mLayout.Height || layout.BgColor != mLayout.BgColor) {
+				mMaker.drawLayout(mImage, layout);
+				mDirtyRects.push_back(Rect(0, 0, mImage.cols, mImage.rows));
+			}
+			else {
+				const vector<IDFlowShape>& previous = mLayout.Shapes;
+				const vector<IDFlowShape>& current = layout.Shapes;
+				for (size_t i = 0, size = max(previous.size(), current.size()); i < size; i++) {
+					if (i < previous.size() && i < current.size() && previous[i] == current[i])
+						continue;
+					if (i < previous.size())
+						addDirtyRect(previous[i].Bounds);
+					if (i < current.size())
+						addDirtyRect(current[i].Bounds);
+				}
+
+				for (const Rect& rect : mDirtyRects)
+					mMaker.drawLayout(mImage, layout, rect);
+			}
+
+			mLayout = layout;
+			return mDirtyRects;
+		}
+
+		/**
+		 * @brief Update the image to the inter-dimensional flow of new aggregated data, the same way as IDFlowMaker::createFlow
+		 * @param aggregate Aggregated data of inter-dimensional flow
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 * @return Non-overlapping areas of the image that were redrawn
+		 */
+		const vector<Rect>& render(const IDFlowAggregate& aggregate, const string totalLabel, const double countPerPixel) {
+			return render(mMaker.layoutFlow(aggregate, totalLabel, countPerPixel));
+		}
+
+		/**
+		 * @brief Image property getter
+		 * @return Last drawn image of inter-dimensional flow
+		 */
+		const Mat& getImage() const { return mImage; }
+		/**
+		 * @brief Layout property getter
+		 * @return Last drawn layout of inter-dimensional flow
+		 */
+		const IDFlowLayout& getLayout() const { return mLayout; }
+		/**
+		 * @brief DirtyRects property getter
+		 * @return Areas of the image redrawn by the last call of render
+		 */
+		const vector<Rect>& getDirtyRects() const { return mDirtyRects; }
+
+		__declspec(property(get = getImage)) const Mat& Image;
+		__declspec(property(get = getLayout)) const IDFlowLayout& Layout;
+		__declspec(property(get = getDirtyRects)) const vector<Rect>& DirtyRects;
+
+	private:
+		IDFlowMaker mMaker;
+		Mat mImage;
+		IDFlowLayout mLayout;
+		vector<Rect> mDirtyRects;
+
+		void addDirtyRect(Rect rect) {
+			rect &= Rect(0, 0, mImage.cols, mImage.rows);
+			if (rect.empty())
+				return;
+
+			// merge the overlapping areas, so that no pixel is redrawn twice
+			for (size_t i = 0; i < mDirtyRects.size();) {
+				if ((mDirtyRects[i] & rect).empty()) {
+					i++;
+					continue;
+				}
+				rect |= mDirtyRects[i];
+				mDirtyRects.erase(mDirtyRects.begin() + i);
+				i = 0;
+			}
+			mDirtyRects.push_back(rect);
+		}
+	};
+
+	/**
+	 * @brief Keeps the image of an inter-dimensional flow with one group or ribbon in focus: the figures connected to it are drawn as usual and the rest
+	 *		  are dimmed. The image is composed of two cached layers, the plain and the dimmed one, so changing the focus only copies the areas of the
+	 *		  previous and the new figures in focus and draws the new ones over them
+	 */
+	class IDFlowHighlighter {
+	public:
+		/**
+		 * @brief IDFlowHighlighter instance constructor
+		 * @param pParams Instance of IDFlowParams class used to create inter-dimensional flows
+		 * @param pDimAlpha Opacity of the figures out of focus over the background, from 0 to 1
+		 */
+		explicit IDFlowHighlighter(const IDFlowParams& pParams, const double pDimAlpha = DEFAULT_DIM_ALPHA) : mMaker(pParams) {
+			DimAlpha = pDimAlpha;
+		}
+
+		/**
+		 * @brief Draw both layers of a new layout and show it without focus
+		 * @param layout Layout of inter-dimensional flow, e.g. from IDFlowMaker::layoutFlow
+		 * @return Image of inter-dimensional flow
+		 */
+		const Mat& render(const IDFlowLayout& layout) {
+			mLayout = layout;
+			mIndex = IDFlowHitIndex(layout);
+			mSelection.clear();
+
+			const vector<IDFlowShape>& shapes = layout.Shapes;
+			const Scalar bgColor = layout.BgColor;
+			vector<IDFlowShape> dimmedShapes;
+			for (const IDFlowShape& shape : shapes)
+				if (shape.Ribbon)
+					dimmedShapes.push_back(IDFlowShape(shape.Source, shape.Target, shape.SourceHeight, shape.TargetHeight, dim(shape.Fill, bgColor), dim(shape.TargetFill, bgColor),
+						shape.Label, shape.Caption, shape.Total));
+				else
+					dimmedShapes.push_back(IDFlowShape(shape.Bounds, dim(shape.Fill, bgColor), shape.Label, shape.Caption, shape.Total));
+
+			mMaker.drawLayout(mPlain, layout);
+			mMaker.drawLayout(mDimmed, IDFlowLayout(layout.Width, layout.Height, bgColor, layout.CountPerPixel, std::move(dimmedShapes)));
+			mPlain.copyTo(mImage);
+			connect();
+
+			mDirtyRects.assign(1, Rect(0, 0, mImage.cols, mImage.rows));
+			return mImage;
+		}
+
+		/**
+		 * @brief Focus on a figure. A rectangle brings into focus the ribbons starting or ending at it and the rectangles at their other ends;
+		 *		  a ribbon brings into focus the rectangles at its ends
+		 * @param shape Index of the figure in the layout
+		 * @return Non-overlapping areas of the image that were redrawn
+		 */
+		const vector<Rect>& highlight(const size_t shape) {
+			if (shape >= mLayout.Shapes.size())
+				throw invalid_argument("Shape index is out of range");
+
+			vector<size_t> selection{ shape };
+			const auto addEnds = [&](const size_t ribbon) {
+				selection.push_back(ribbon);
+				for (const ptrdiff_t end : { mEnds[ribbon].first, mEnds[ribbon].second })
+					if (end >= 0)
+						selection.push_back(end);
+			};
+			if (mLayout.Shapes[shape].Ribbon)
+				addEnds(shape);
+			else
+				for (const size_t ribbon : mRibbons[shape])
+					addEnds(ribbon);
+
+			sort(selection.begin(), selection.end());
+			selection.erase(unique(selection.begin(), selection.end()), selection.end());
+			return show(selection);
+		}
+
+		/**
+		 * @brief Focus on the figure drawn at a point of the image, e.g. the one clicked, or remove the focus if there is only the background
+		 * @param x Column of the image
+		 * @param y Row of the image
+		 * @return Non-overlapping areas of the image that were redrawn
+		 */
+		const vector<Rect>& highlight(const int x, const int y) {
+			const IDFlowShape* shape = mIndex.hitTest(x, y);
+			return shape == nullptr ? clear() : highlight(static_cast<size_t>(shape - mIndex.Layout.Shapes.data()));
+		}
+
+		/**
+		 * @brief Remove the focus and show every figure as usual
+		 * @return Non-overlapping areas of the image that were redrawn
+		 */
+		const vector<Rect>& clear() {
+			return show({});
+		}
+
+		/**
+		 * @brief DimAlpha property setter
+		 * @param pDimAlpha Opacity of the figures out of focus over the background, from 0 to 1. Applies from the next call of render
+		 */
+		void putDimAlpha(double pDimAlpha) {
+			if (pDimAlpha < 0 || pDimAlpha > 1)
+				throw invalid_argument("Dim alpha must be between 0 and 1");
+			mDimAlpha = pDimAlpha;
+		}
+		/**
+		 * @brief DimAlpha property getter
+		 * @return DimAlpha value
+		 */
+		double getDimAlpha() const { return mDimAlpha; }
+
+		/**
+		 * @brief Image property getter
+		 * @return Image of inter-dimensional flow with the current focus
+		 */
+		const Mat& getImage() const { return mImage; }
+		/**
+		 * @brief Layout property getter
+		 * @return Last drawn layout of inter-dimensional flow
+		 */
+		const IDFlowLayout& getLayout() const { return mLayout; }
+		/**
+		 * @brief Selection property getter
+		 * @return Sorted indexes of the figures in focus, empty without focus
+		 */
+		const vector<size_t>& getSelection() const { return mSelection; }
+		/**
+		 * @brief DirtyRects property getter
+		 * @return Areas of the image redrawn by the last call
+		 */
+		const vector<Rect>& getDirtyRects() const { return mDirtyRects; }
+
+		__declspec(property(get = getDimAlpha, put = putDimAlpha)) double DimAlpha;
+		__declspec(property(get = getImage)) const Mat& Image;
+		__declspec(property(get = getLayout)) const IDFlowLayout& Layout;
+		__declspec(property(get = getSelection)) const vector<size_t>& Selection;
+		__declspec(property(get = getDirtyRects)) const vector<Rect>& DirtyRects;
+
+	private:
+		static constexpr double DEFAULT_DIM_ALPHA = 0.2;
+
+		IDFlowMaker mMaker;
+		double mDimAlpha;
+		IDFlowLayout mLayout;
+		IDFlowHitIndex mIndex;
+		Mat mPlain;
+		Mat mDimmed;
+		Mat mImage;
+		vector<pair<ptrdiff_t, ptrdiff_t>> mEnds;
+		vector<vector<size_t>> mRibbons;
+		vector<size_t> mSelection;
+		vector<Rect> mDirtyRects;
+
+		Scalar dim(const Scalar& color, const Scalar& bgColor) const {
+			Scalar result;
+			for (size_t i = 0; i <= 2; i++)
+				result[i] = mDimAlpha * color[i] + (1 - mDimAlpha) * bgColor[i];
+			return result;
+		}
+
+		void connect() {
+			const vector<IDFlowShape>& shapes = mLayout.Shapes;
+
+			// the ends of the ribbons lie on the left or the right edges of the rectangles
+			map<int, vector<size_t>> edges;
+			for (size_t i = 0, size = shapes.size(); i < size; i++)
+				if (!shapes[i].Ribbon) {
+					edges[shapes[i].Bounds.x].push_back(i);
+					edges[shapes[i].Bounds.x + shapes[i].Bounds.width].push_back(i);
+				}
+			for (auto& edge : edges)
+				sort(edge.second.begin(), edge.second.end(), [&](const size_t a, const size_t b) { return shapes[a].Bounds.y < shapes[b].Bounds.y; });
+
+			const auto find = [&](const Point2d end) -> ptrdiff_t {
+				const auto edge = edges.find(cvRound(end.x));
+				if (edge == edges.end())
+					return -1;
+				const vector<size_t>& rectangles = edge->second;
+				const auto next = upper_bound(rectangles.begin(), rectangles.end(), end.y, [&](const double y, const size_t i) { return y < shapes[i].Bounds.y; });
+				if (next == rectangles.begin())
+					return -1;
+				const Rect bounds = shapes[*prev(next)].Bounds;
+				return end.y <= bounds.y + bounds.height ? static_cast<ptrdiff_t>(*prev(next)) : -1;
+			};
+
+			mEnds.assign(shapes.size(), { -1, -1 });
+			mRibbons.assign(shapes.size(), {});
+			for (size_t i = 0, size = shapes.size(); i < size; i++)
+				if (shapes[i].Ribbon) {
+					mEnds[i] = { find(shapes[i].Source), find(shapes[i].Target) };
+					for (const ptrdiff_t end : { mEnds[i].first, mEnds[i].second })
+						if (end >= 0)
+							mRibbons[end].push_back(i);
+				}
+		}
+
+		const vector<Rect>& show(const vector<size_t>& selection) {
+			if (mImage.empty())
+				throw length_error("Layout must be rendered first");
+
+			mDirtyRects.clear();
+			if (selection == mSelection)
+				return mDirtyRects;
+
+			const vector<IDFlowShape>& shapes = mLayout.Shapes;
+			const Rect image(0, 0, mImage.cols, mImage.rows);
+			if (selection.empty() || mSelection.empty()) {
+				(selection.empty() ? mPlain : mDimmed).copyTo(mImage);
+				mDirtyRects.push_back(image);
+			}
+			else {
+				for (const size_t i : mSelection)
+					addDirtyRect(shapes[i].Bounds & image);
+				for (const size_t i : selection)
+					addDirtyRect(shapes[i].Bounds & image);
+				for (const Rect& rect : mDirtyRects)
+					mDimmed(rect).copyTo(mImage(rect));
+			}
+
+			vector<IDFlowShape> focused;
+			for (const size_t i : selection)
+				focused.push_back(shapes[i]);
+			for (const Rect& rect : mDirtyRects)
+				mMaker.drawShapes(mImage, focused, rect);
+
+			mSelection = selection;
+			return mDirtyRects;
+		}
+
+		void addDirtyRect(Rect rect) {
+			if (rect.empty())
+				return;
+
+			// merge the overlapping areas, so that no pixel is redrawn twice
+			for (size_t i = 0; i < mDirtyRects.size();) {
+				if ((mDirtyRects[i] & rect).empty()) {
+					i++;
+					continue;
+				}
+				rect |= mDirtyRects[i];
+				mDirtyRects.erase(mDirtyRects.begin() + i);
+				i = 0;
+			}
+			mDirtyRects.push_back(rect);
+		}
+	};
+
+	/**
+	 * @brief Animates the transition between two inter-dimensional flows, e.g. of consecutive weeks. Figures of the same group are matched by their
+	 *		  column and label and move, resize and change color from one layout to the other; the figures present in only one layout grow from or
+	 *		  shrink into their place while fading in or out
+	 */
+	class IDFlowAnimator {
+	public:
+		/**
+		 * @brief IDFlowAnimator instance constructor
+		 * @param pParams Instance of IDFlowParams class used to create inter-dimensional flows
+		 */
+		explicit IDFlowAnimator(const IDFlowParams& pParams) : mMaker(pParams) {}
+
+		/**
+		 * @brief Compute one frame of a transition. The frame is as large as the larger of the layouts; the captions switch halfway
+		 * @param from Layout at the start of the transition
+		 * @param to Layout at the end of the transition
+		 * @param progress Progress of the transition from 0 (the first layout) to 1 (the second layout)
+		 * @return Layout of the frame
+		 */
+		static IDFlowLayout interpolate(const IDFlowLayout& from, const IDFlowLayout& to, const double progress) {
+			if (progress < 0 || progress > 1)
+				throw invalid_argument("Progress must be between 0 and 1");
+
+			const vector<IDFlowShape>& fromShapes = from.Shapes;
+			const vector<IDFlowShape>& toShapes = to.Shapes;
+			map<tuple<bool, double, string>, size_t> toKeys;
+			for (size_t i = 0, size = toShapes.size(); i < size; i++)
+				toKeys.emplace(getKey(toShapes[i]), i);
+
+			vector<ptrdiff_t> matches(fromShapes.size(), -1);
+			vector<bool> matched(toShapes.size(), false);
+			for (size_t i = 0, size = fromShapes.size(); i < size; i++) {
+				const auto key = toKeys.find(getKey(fromShapes[i]));
+				if (key != toKeys.end() && !matched[key->second]) {
+					matches[i] = key->second;
+					matched[key->second] = true;
+				}
+			}
+
+			// the shapes keep the drawing order of the closer layout, followed by the ones missing from it
+			vector<IDFlowShape> shapes;
+			const auto add = [&](const IDFlowShape& start, const IDFlowShape& end) {
+				const IDFlowShape& nearest = progress < 0.5 ? start : end;
+				if (start.Ribbon) {
+					const int sourceHeight = mix(start.SourceHeight, end.SourceHeight, progress);
+					const int targetHeight = mix(start.TargetHeight, end.TargetHeight, progress);
+					if (sourceHeight > 0 || targetHeight > 0)
+						shapes.push_back(IDFlowShape(mix(start.Source, end.Source, progress), mix(start.Target, end.Target, progress), sourceHeight, targetHeight,
+							mix(start.Fill, end.Fill, progress), mix(start.TargetFill, end.TargetFill, progress), nearest.Label, nearest.Caption,
+							start.Total + (end.Total - start.Total) * progress));
+				}
+				else {
+					const Rect bounds(mix(start.Bounds.x, end.Bounds.x, progress), mix(start.Bounds.y, end.Bounds.y, progress),
+						mix(start.Bounds.width, end.Bounds.width, progress), mix(start.Bounds.height, end.Bounds.height, progress));
+					if (!bounds.empty())
+						shapes.push_back(IDFlowShape(bounds, mix(start.Fill, end.Fill, progress), nearest.Label, nearest.Caption, start.Total + (end.Total - start.Total) * progress));
+				}
+			};
+
+			if (progress < 0.5) {
+				for (size_t i = 0, size = fromShapes.size(); i < size; i++)
+					add(fromShapes[i], matches[i] < 0 ? collapse(fromShapes[i], to.BgColor) : toShapes[matches[i]]);
+				for (size_t i = 0, size = toShapes.size(); i < size; i++)
+					if (!matched[i])
+						add(collapse(toShapes[i], from.BgColor), toShapes[i]);
+			}
+			else {
+				vector<ptrdiff_t> sources(toShapes.size(), -1);
+				for (size_t i = 0, size = fromShapes.size(); i < size; i++)
+					if (matches[i] >= 0)
+						sources[matches[i]] = i;
+				for (size_t i = 0, size = toShapes.size(); i < size; i++)
+					add(sources[i] < 0 ? collapse(toShapes[i], from.BgColor) : fromShapes[sources[i]], toShapes[i]);
+				for (size_t i = 0, size = fromShapes.size(); i < size; i++)
+					if (matches[i] < 0)
+						add(fromShapes[i], collapse(fromShapes[i], to.BgColor));
+			}
+
+			return IDFlowLayout(max(from.Width, to.Width), max(from.Height, to.Height), mix(from.BgColor, to.BgColor, progress),
+				from.CountPerPixel + (to.CountPerPixel - from.CountPerPixel) * progress, std::move(shapes));
+		}
+
+		/**
+		 * @brief Draw the frames of a transition. The next frame is drawn on a separate thread while the callback handles the current one, e.g. encodes it
+		 * @param from Layout at the start of the transition
+		 * @param to Layout at the end of the transition
+		 * @param frames Number of frames, including the first and the last layout
+		 * @param callback Function receiving each frame and its index
+		 */
+		void animate(const IDFlowLayout& from, const IDFlowLayout& to, const int frames, const function<void(const Mat&, int)>& callback) {
+			if (frames <= 0)
+				throw invalid_argument("Number of frames must be greater than 0");
+
+			const auto draw = [this, &from, &to, frames](const int frame) {
+				Mat image;
+				mMaker.drawLayout(image, interpolate(from, to, frames == 1 ? 1 : static_cast<double>(frame) / (frames - 1)));
+				return image;
+			};
+
+			future<Mat> next = async(launch::async, draw, 0);
+			for (int frame = 0; frame < frames; frame++) {
+				const Mat image = next.get();
+				if (frame + 1 < frames)
+					next = async(launch::async, draw, frame + 1);
+				callback(image, frame);
+			}
+		}
+
+		/**
+		 * @brief Write the frames of a transition to a video. A VideoWriter opened with a file name pattern such as "frame_%04d.png" writes an image sequence
+		 * @param writer VideoWriter opened with the size of the larger of the layouts
+		 * @param from Layout at the start of the transition
+		 * @param to Layout at the end of the transition
+		 * @param frames Number of frames, including the first and the last layout
+		 */
+		void write(VideoWriter& writer, const IDFlowLayout& from, const IDFlowLayout& to, const int frames) {
+			if (!writer.isOpened())
+				throw invalid_argument("Video writer must be opened");
+
+			animate(from, to, frames, [&](const Mat& image, int) { writer.write(image); });
+		}
+
+	private:
+		IDFlowMaker mMaker;
+
+		static tuple<bool, double, string> getKey(const IDFlowShape& shape) {
+			return { shape.Ribbon, shape.Source.x, shape.Label };
+		}
+
+		static IDFlowShape collapse(const IDFlowShape& shape, const Scalar& bgColor) {
+			if (shape.Ribbon)
+				return IDFlowShape(shape.Source, shape.Target, 0, 0, bgColor, bgColor, shape.Label, shape.Caption, 0);
+			return IDFlowShape(Rect(shape.Bounds.x, shape.Bounds.y, shape.Bounds.width, 0), bgColor, shape.Label, shape.Caption, 0);
+		}
+
+		static int mix(const int start, const int end, const double progress) {
+			return cvRound(start + (end - start) * progress);
+		}
+
+		static Point2d mix(const Point2d& start, const Point2d& end, const double progress) {
+			return Point2d(start.x + (end.x - start.x) * progress, start.y + (end.y - start.y) * progress);
+		}
+
+		static Scalar mix(const Scalar& start, const Scalar& end, const double progress) {
+			Scalar result;
+			for (size_t i = 0; i <= 2; i++)
+				result[i] = start[i] + (end[i] - start[i]) * progress;
+			return result;
+		}
+	};
+
+	/**
+	 * @brief Encodes images of inter-dimensional flows into memory, e.g. on a server without a display. Encoder parameters are tuned for images
+	 *		  made of large areas of flat color
+	 */
+	class IDFlowEncoder {
+	public:
+		/**
+		 * @brief IDFlowEncoder instance constructor
+		 * @param pExtension Image format: ".png", ".jpg", ".jpeg" or ".webp"
+		 * @param pLevel PNG compression level from 0 (fastest) to 9 (smallest), or JPEG and WebP quality from 1 to 100; WebP quality above 100
+		 *		  is lossless. -1 selects the default of the format: the fast PNG settings of OpenCV, JPEG quality 95 and lossless WebP
+		 */
+		explicit IDFlowEncoder(const string pExtension = ".png", const int pLevel = -1) {
+			Extension = pExtension;
+			Level = pLevel;
+		}
+
+		/**
+		 * @brief Encode an image
+		 * @param image Matrix (image) containing an inter-dimensional flow
+		 * @return Encoded image
+		 */
+		vector<uchar> encode(const Mat& image) const {
+			vector<uchar> buffer;
+			if (!imencode(mExtension, image, buffer, getParams()))
+				throw invalid_argument("Image can not be encoded as " + mExtension);
+			return buffer;
+		}
+
+		/**
+		 * @brief Encode an image on a separate thread, e.g. while the next image is drawn. The image must not be modified until the encoding
+		 *		  is finished; drawing into a new matrix, as createFlow does, is safe
+		 * @param image Matrix (image) containing an inter-dimensional flow
+		 * @return Encoded image, once it is ready
+		 */
+		future<vector<uchar>> encodeAsync(const Mat& image) const {
+			return async(launch::async, [encoder = *this, image]() {
+				return encoder.encode(image);
+			});
+		}
+
+		/**
+		 * @brief Draw and encode an inter-dimensional flow into a stream. With IDFLOW_HAVE_LIBPNG defined, PNG images are drawn a strip of rows
+		 *		  at a time and every strip is passed to libpng as soon as it is drawn, so the whole image is never held in memory; the output is
+		 *		  the same as encoding the whole image with OpenCV built against the same libpng. Other formats are drawn whole and encoded with encode
+		 * @param output Output stream, opened in binary mode
+		 * @param maker Instance of IDFlowMaker class used to draw the flow
+		 * @param layout Layout of inter-dimensional flow
+		 */
+		void write(ostream& output, IDFlowMaker& maker, const IDFlowLayout& layout) const {
+#if defined(IDFLOW_HAVE_LIBPNG)
+			if (mExtension == ".png") {
+				writePng(output, maker, layout);
+				return;
+			}
+#endif
+			Mat image;
+			maker.drawLayout(image, layout);
+			const vector<uchar> buffer = encode(image);
+			if (!output.write(reinterpret_cast<const char*>(buffer.data()), buffer.size()))
+				throw invalid_argument("Image can not be written");
+		}
+
+		/**
+		 * @brief Extension property setter
+		 * @param pExtension Image format: ".png", ".jpg", ".jpeg" or ".webp"
+		 */
+		void putExtension(string pExtension) {
+			transform(pExtension.begin(), pExtension.end(), pExtension.begin(), [](const unsigned char c) { return static_cast<char>(tolower(c)); });
+			if (pExtension != ".png" && pExtension != ".jpg" && pExtension != ".jpeg" && pExtension != ".webp")
+				throw invalid_argument("Unsupported image format: " + pExtension);
+			mExtension = pExtension;
+		}
+		/**
+		 * @brief Extension property getter
+		 * @return Extension value
+		 */
+		string getExtension() const { return mExtension; }
+
+		/**
+		 * @brief Level property setter
+		 * @param pLevel PNG compression level from 0 to 9, JPEG quality from 1 to 100, WebP quality from 1 to 101, or -1 for the default
+		 */
+		void putLevel(int pLevel) {
+			if (pLevel < -1 || pLevel > 101)
+				throw invalid_argument("Level must be between -1 and 101");
+			mLevel = pLevel;
+		}
+		/**
+		 * @brief Level property getter
+		 * @return Level value
+		 */
+		int getLevel() const { return mLevel; }
+
+		/**
+		 * @brief Params property getter
+		 * @return Parameters passed to imencode
+		 */
+		vector<int> getParams() const {
+			if (mExtension == ".png") {
+				// without parameters OpenCV already picks its fastest settings: level 1, the Sub filter and the RLE strategy; a level resets the
+				// strategy to the default one, so RLE is passed again, as flow images are mostly runs of equal pixels
+				if (mLevel < 0)
+					return {};
+				return { IMWRITE_PNG_COMPRESSION, min(mLevel, 9), IMWRITE_PNG_STRATEGY, IMWRITE_PNG_STRATEGY_RLE };
+			}
+			if (mExtension == ".webp")
+				return { IMWRITE_WEBP_QUALITY, mLevel < 0 ? LOSSLESS_WEBP_QUALITY : max(mLevel, 1) };
+			return { IMWRITE_JPEG_QUALITY, mLevel < 0 ? DEFAULT_JPEG_QUALITY : clamp(mLevel, 1, 100) };
+		}
+
+		__declspec(property(get = getExtension, put = putExtension)) string Extension;
+		__declspec(property(get = getLevel, put = putLevel)) int Level;
+		__declspec(property(get = getParams)) vector<int> Params;
+
+	private:
+		static const int DEFAULT_JPEG_QUALITY = 95;
+		static const int LOSSLESS_WEBP_QUALITY = 101;
+
+		string mExtension;
+		int mLevel;
+
+#if defined(IDFLOW_HAVE_LIBPNG)
+		static const int PNG_STRIP_ROWS = 256;
+		static const int FAST_PNG_LEVEL = 1;
+
+		struct IDFlowPngWriter {
+			png_structp Png = nullptr;
+			png_infop Info = nullptr;
+			char Error[256] = {};
+			bool Unwritten = false;
+
+			~IDFlowPngWriter() { png_destroy_write_struct(&Png, &Info); }
+		};
+
+		void writePng(ostream& output, IDFlowMaker& maker, const IDFlowLayout& layout) const {
+			// libpng reports errors by a long jump, which must not cross C++ frames: the callbacks only record the error and jump back into
+			// the write* helpers below, which hold no objects with destructors; the exception is thrown once control is back here
+			const vector<int> params = getParams();
+
+			IDFlowPngWriter writer;
+			writer.Png = png_create_write_struct(PNG_LIBPNG_VER_STRING, &writer,
+				[](png_structp png, png_const_charp message) {
+					IDFlowPngWriter* failed = static_cast<IDFlowPngWriter*>(png_get_error_ptr(png));
+					strncpy(failed->Error, message, sizeof(failed->Error) - 1);
+					png_longjmp(png, 1);
+				}, nullptr);
+			if (writer.Png == nullptr || (writer.Info = png_create_info_struct(writer.Png)) == nullptr)
+				throw invalid_argument("Image can not be encoded as .png");
+
+			png_set_write_fn(writer.Png, &output,
+				[](png_structp png, png_bytep data, size_t size) {
+					if (!static_cast<ostream*>(png_get_io_ptr(png))->write(reinterpret_cast<const char*>(data), size)) {
+						static_cast<IDFlowPngWriter*>(png_get_error_ptr(png))->Unwritten = true;
+						png_error(png, "Image can not be written");
+					}
+				},
+				[](png_structp png) { static_cast<ostream*>(png_get_io_ptr(png))->flush(); });
+
+			if (!writePngInfo(writer, layout.Width, layout.Height, params.empty() ? -1 : params[1], params.empty() ? -1 : params[3]))
+				throwPngError(writer);
+			maker.drawTiles(layout, Size(layout.Width, PNG_STRIP_ROWS), [&](const Mat& strip, const Rect&) {
+				if (!writePngRows(writer, strip))
+					throwPngError(writer);
+			});
+			if (!writePngEnd(writer))
+				throwPngError(writer);
+		}
+
+		static bool writePngInfo(IDFlowPngWriter& writer, const int width, const int height, const int level, const int strategy) {
+			if (setjmp(png_jmpbuf(writer.Png)))
+				return false;
+			// the same settings as the PNG encoder of OpenCV: without parameters level 1 with the Sub filter, otherwise the given level with
+			// the default filters; the given strategy or RLE; 8-bit BGR rows
+			if (level < 0) {
+				png_set_filter(writer.Png, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+				png_set_compression_level(writer.Png, FAST_PNG_LEVEL);
+			}
+			else
+				png_set_compression_level(writer.Png, level);
+			png_set_compression_strategy(writer.Png, strategy < 0 ? IMWRITE_PNG_STRATEGY_RLE : strategy);
+			png_set_IHDR(writer.Png, writer.Info, width, height, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+			png_write_info(writer.Png, writer.Info);
+			png_set_bgr(writer.Png);
+			return true;
+		}
+
+		static bool writePngRows(IDFlowPngWriter& writer, const Mat& strip) {
+			if (setjmp(png_jmpbuf(writer.Png)))
+				return false;
+			for (int y = 0; y < strip.rows; y++)
+				png_write_row(writer.Png, strip.ptr(y));
+			return true;
+		}
+
+		static bool writePngEnd(IDFlowPngWriter& writer) {
+			if (setjmp(png_jmpbuf(writer.Png)))
+				return false;
+			png_write_end(writer.Png, writer.Info);
+			return true;
+		}
+
+		static void throwPngError(const IDFlowPngWriter& writer) {
+			if (writer.Unwritten)
+				throw invalid_argument("Image can not be written");
+			throw invalid_argument(string("Image can not be encoded as .png: ") + writer.Error);
+		}
+#endif
+	};
+
+	/**
+	 * @brief Writes an inter-dimensional flow to disk as a pyramid of tiles, for images too large to be held in memory. Level 0 holds the image
+	 *		  in full size, and every next level halves the previous one until it fits into one tile. Tiles are stored as
+	 *		  "<directory>/<level>/<column>_<row><extension>"
+	 */
+	class IDFlowPyramid {
+	public:
+		/**
+		 * @brief IDFlowPyramid instance constructor
+		 * @param pParams Instance of IDFlowParams class used to create inter-dimensional flows
+		 * @param pTileSize Width and height of the tiles in pixels
+		 * @param pEncoder Instance of IDFlowEncoder class used to encode the tiles
+		 */
+		IDFlowPyramid(const IDFlowParams& pParams, const int pTileSize = 1024, const IDFlowEncoder& pEncoder = IDFlowEncoder()) : mMaker(pParams), mEncoder(pEncoder) {
+			TileSize = pTileSize;
+		}
+
+		/**
+		 * @brief Write a pyramid of tiles. Tiles are drawn one at a time and every four of them are merged into the tile of the next level as soon
+		 *		  as they are written, so only a few tiles per level are held in memory at once
+		 * @param directory Output directory, created if it does not exist
+		 * @param layout Layout of inter-dimensional flow
+		 * @return Number of levels
+		 */
+		int write(const string& directory, const IDFlowLayout& layout) {
+			vector<Size> sizes{ Size(layout.Width, layout.Height) };
+			while (sizes.back().width > mTileSize || sizes.back().height > mTileSize)
+				sizes.push_back(Size((sizes.back().width + 1) / 2, (sizes.back().height + 1) / 2));
+
+			const int levels = static_cast<int>(sizes.size());
+			for (int level = 0; level < levels; level++)
+				filesystem::create_directories(filesystem::path(directory) / to_string(level));
+
+			vector<size_t> shapes(layout.Shapes.size());
+			iota(shapes.begin(), shapes.end(), 0);
+			mMaker.prepareLayout(layout);
+			writeTile(directory, layout, sizes, levels - 1, 0, 0, shapes);
+			return levels;
+		}
+
+		/**
+		 * @brief Write a pyramid of tiles of inter-dimensional flow of aggregated data, laid out the same way as by IDFlowMaker::createFlow
+		 * @param directory Output directory, created if it does not exist
+		 * @param aggregate Aggregated data of inter-dimensional flow
+		 * @param totalLabel A string that is used as a header for the middle section of inter-dimensional flow
+		 * @param countPerPixel A fractional number used as a denominator when calculating the height or resulting rectangles on the inter-dimensional flow.
+		 *		  0 fits the flow into a fixed ImageHeight with the largest possible figures
+		 * @return Number of levels
+		 */
+		int write(const string& directory, const IDFlowAggregate& aggregate, const string totalLabel, const double countPerPixel) {
+			return write(directory, mMaker.layoutFlow(aggregate, totalLabel, countPerPixel));
+		}
+
+		/**
+		 * @brief TileSize property setter
+		 * @param pTileSize Width and height of the tiles in pixels
+		 */
+		void putTileSize(int pTileSize) {
+			if (pTileSize <= 0)
+				throw invalid_argument("Tile size must be greater than 0");
+			mTileSize = pTileSize;
+		}
+		/**
+		 * @brief TileSize property getter
+		 * @return TileSize value
+		 */
+		int getTileSize() const { return mTileSize; }
+
+		/**
+		 * @brief Encoder property getter
+		 * @return Instance of IDFlowEncoder class used to encode the tiles
+		 */
+		const IDFlowEncoder& getEncoder() const { return mEncoder; }
+
+		__declspec(property(get = getTileSize, put = putTileSize)) int TileSize;
+		__declspec(property(get = getEncoder)) const IDFlowEncoder& Encoder;
+
+	private:
+		IDFlowMaker mMaker;
+		IDFlowEncoder mEncoder;
+		int mTileSize;
+
+		Rect getFullArea(const IDFlowLayout& layout, const int level, const int column, const int row) const {
+			const long long size = static_cast<long long>(mTileSize) << level;
+			const int left = static_cast<int>(min(column * size, static_cast<long long>(layout.Width)));
+			const int top = static_cast<int>(min(row * size, static_cast<long long>(layout.Height)));
+			const int right = static_cast<int>(min((column + 1) * size, static_cast<long long>(layout.Width)));
+			const int bottom = static_cast<int>(min((row + 1) * size, static_cast<long long>(layout.Height)));
+			return Rect(left, top, right - left, bottom - top);
+		}
+
+		Mat writeTile(const string& directory, const IDFlowLayout& layout, const vector<Size>& sizes, const int level, const int column, const int row,
+			const vector<size_t>& shapes) {
+
+			const Rect area = Rect(column * mTileSize, row * mTileSize, mTileSize, mTileSize) & Rect(Point(0, 0), sizes[level]);
+
+			// only the figures crossing the part of the full-size image under this tile are passed down to its children
+			const Rect fullArea = getFullArea(layout, level, column, row);
+			vector<size_t> tileShapes;
+			for (const size_t i : shapes)
+				if (!(layout.Shapes[i].Bounds & fullArea).empty())
+					tileShapes.push_back(i);
+
+			Mat tile;
+			if (level == 0)
+				mMaker.drawTile(tile, layout, area, tileShapes);
+			else {
+				// the children cover one pixel less than twice the tile where the level below is odd-sized, so only the covered part is shrunk
+				const Size below = sizes[level - 1];
+				Mat merged(min(mTileSize * 2, below.height - row * 2 * mTileSize), min(mTileSize * 2, below.width - column * 2 * mTileSize), CV_8UC3);
+				for (int y = 0; y < 2; y++)
+					for (int x = 0; x < 2; x++)
+						if (x * mTileSize < merged.cols && y * mTileSize < merged.rows) {
+							const Mat part = writeTile(directory, layout, sizes, level - 1, column * 2 + x, row * 2 + y, tileShapes);
+							part.copyTo(merged(Rect(x * mTileSize, y * mTileSize, part.cols, part.rows)));
+						}
+				resize(merged, tile, area.size(), 0, 0, INTER_AREA);
+			}
+
+			const vector<uchar> buffer = mEncoder.encode(tile);
+			const filesystem::path path = filesystem::path(directory) / to_string(level) / (to_string(column) + "_" + to_string(row) + mEncoder.Extension);
+			ofstream file(path, ios::binary);
+			if (!file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size()))
+				throw invalid_argument("File can not be written: " + path.string());
+			return tile;
+		}
+	};
 }
\ No newline at end of file
@@ -16,19 +16,28 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
 #ifdef HAS_CODECVT
 #include <codecvt>
 #include <locale>
 #endif
+#include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <list>
 #include <map>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
 namespace rapidcsv
@@ -452,854 +461,2808 @@ namespace rapidcsv
   };
 
   /**
-   * @brief     Class representing a CSV document.
+   * @brief     Datastructure holding a condition on the cells of one column. Rows not matching
+   *            the condition are dropped while the CSV data is parsed.
    */
-  class Document
+  struct RowFilter
   {
-  public:
     /**
-     * @brief   Constructor
-     * @param   pPath                 specifies the path of an existing CSV-file to populate the Document
-     *                                data with.
-     * @param   pLabelParams          specifies which row and column should be treated as labels.
-     * @param   pSeparatorParams      specifies which field and row separators should be used.
-     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
-     *                                handled.
-     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @brief   Kind of condition checked by a RowFilter.
      */
-    explicit Document(const std::string& pPath = std::string(),
-                      const LabelParams& pLabelParams = LabelParams(),
-                      const SeparatorParams& pSeparatorParams = SeparatorParams(),
-                      const ConverterParams& pConverterParams = ConverterParams(),
-                      const LineReaderParams& pLineReaderParams = LineReaderParams())
-      : mPath(pPath)
-      , mLabelParams(pLabelParams)
-      , mSeparatorParams(pSeparatorParams)
-      , mConverterParams(pConverterParams)
-      , mLineReaderParams(pLineReaderParams)
-      , mData()
-      , mColumnNames()
-      , mRowNames()
+    enum FilterType
     {
-      if (!mPath.empty())
-      {
-        ReadCsv();
-      }
-    }
+      FilterEqual,
+      FilterOneOf,
+      FilterPrefix,
+      FilterTextRange,
+      FilterNumericRange
+    };
 
     /**
      * @brief   Constructor
-     * @param   pStream               specifies a binary input stream to read CSV data from.
-     * @param   pLabelParams          specifies which row and column should be treated as labels.
-     * @param   pSeparatorParams      specifies which field and row separators should be used.
-     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
-     *                                handled.
-     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @param   pType                 specifies the kind of condition.
+     * @param   pColumnName           specifies the column label name (used when pColumnIdx < 0).
+     * @param   pColumnIdx            specifies the zero-based column index, or -1 to look up the
+     *                                column by pColumnName.
+     * @param   pValues               specifies the value (FilterEqual, FilterPrefix), the accepted
+     *                                values (FilterOneOf) or the inclusive bounds (FilterTextRange).
+     * @param   pMin                  specifies the inclusive lower bound of FilterNumericRange.
+     * @param   pMax                  specifies the inclusive upper bound of FilterNumericRange.
      */
-    explicit Document(std::istream& pStream,
-                      const LabelParams& pLabelParams = LabelParams(),
-                      const SeparatorParams& pSeparatorParams = SeparatorParams(),
-                      const ConverterParams& pConverterParams = ConverterParams(),
-                      const LineReaderParams& pLineReaderParams = LineReaderParams())
-      : mPath()
-      , mLabelParams(pLabelParams)
-      , mSeparatorParams(pSeparatorParams)
-      , mConverterParams(pConverterParams)
-      , mLineReaderParams(pLineReaderParams)
-      , mData()
-      , mColumnNames()
-      , mRowNames()
+    explicit RowFilter(const FilterType pType, const std::string& pColumnName, const int pColumnIdx,
+                       const std::vector<std::string>& pValues,
+                       const long double pMin = 0, const long double pMax = 0)
+      : mType(pType)
+      , mColumnName(pColumnName)
+      , mColumnIdx(pColumnIdx)
+      , mValues(pValues)
+      , mMin(pMin)
+      , mMax(pMax)
     {
-      ReadCsv(pStream);
+      const size_t valueCount = (mType == FilterTextRange) ? 2 : 1;
+      if ((mType != FilterOneOf) && (mType != FilterNumericRange) && (mValues.size() != valueCount))
+      {
+        throw std::invalid_argument("invalid number of filter values " + std::to_string(mValues.size()));
+      }
+
+      if (mType == FilterOneOf)
+      {
+        std::sort(mValues.begin(), mValues.end());
+      }
     }
 
     /**
-     * @brief   Read Document data from file.
-     * @param   pPath                 specifies the path of an existing CSV-file to populate the Document
-     *                                data with.
-     * @param   pLabelParams          specifies which row and column should be treated as labels.
-     * @param   pSeparatorParams      specifies which field and row separators should be used.
-     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
-     *                                handled.
-     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @brief   Create a filter accepting rows whose cell equals a value.
+     * @param   pColumnName           column label name.
+     * @param   pValue                accepted value.
+     * @returns row filter.
      */
-    void Load(const std::string& pPath,
-              const LabelParams& pLabelParams = LabelParams(),
-              const SeparatorParams& pSeparatorParams = SeparatorParams(),
-              const ConverterParams& pConverterParams = ConverterParams(),
-              const LineReaderParams& pLineReaderParams = LineReaderParams())
+    static RowFilter Equal(const std::string& pColumnName, const std::string& pValue)
     {
-      mPath = pPath;
-      mLabelParams = pLabelParams;
-      mSeparatorParams = pSeparatorParams;
-      mConverterParams = pConverterParams;
-      mLineReaderParams = pLineReaderParams;
-      ReadCsv();
+      return RowFilter(FilterEqual, pColumnName, -1, { pValue });
     }
 
     /**
-     * @brief   Read Document data from stream.
-     * @param   pStream               specifies a binary input stream to read CSV data from.
-     * @param   pLabelParams          specifies which row and column should be treated as labels.
-     * @param   pSeparatorParams      specifies which field and row separators should be used.
-     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
-     *                                handled.
-     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @brief   Create a filter accepting rows whose cell equals a value.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pValue                accepted value.
+     * @returns row filter.
      */
-    void Load(std::istream& pStream,
-              const LabelParams& pLabelParams = LabelParams(),
-              const SeparatorParams& pSeparatorParams = SeparatorParams(),
-              const ConverterParams& pConverterParams = ConverterParams(),
-              const LineReaderParams& pLineReaderParams = LineReaderParams())
+    static RowFilter Equal(const size_t pColumnIdx, const std::string& pValue)
     {
-      mPath = "";
-      mLabelParams = pLabelParams;
-      mSeparatorParams = pSeparatorParams;
-      mConverterParams = pConverterParams;
-      mLineReaderParams = pLineReaderParams;
-      ReadCsv(pStream);
+      return RowFilter(FilterEqual, std::string(), static_cast<int>(pColumnIdx), { pValue });
     }
 
     /**
-     * @brief   Write Document data to file.
-     * @param   pPath                 optionally specifies the path where the CSV-file will be created
-     *                                (if not specified, the original path provided when creating or
-     *                                loading the Document data will be used).
+     * @brief   Create a filter accepting rows whose cell is one of a set of values.
+     * @param   pColumnName           column label name.
+     * @param   pValues               accepted values.
+     * @returns row filter.
      */
-    void Save(const std::string& pPath = std::string())
+    static RowFilter OneOf(const std::string& pColumnName, const std::vector<std::string>& pValues)
     {
-      if (!pPath.empty())
-      {
-        mPath = pPath;
-      }
-      WriteCsv();
+      return RowFilter(FilterOneOf, pColumnName, -1, pValues);
     }
 
     /**
-     * @brief   Write Document data to stream.
-     * @param   pStream               specifies a binary output stream to write the data to.
+     * @brief   Create a filter accepting rows whose cell is one of a set of values.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pValues               accepted values.
+     * @returns row filter.
      */
-    void Save(std::ostream& pStream) const
+    static RowFilter OneOf(const size_t pColumnIdx, const std::vector<std::string>& pValues)
     {
-      WriteCsv(pStream);
+      return RowFilter(FilterOneOf, std::string(), static_cast<int>(pColumnIdx), pValues);
     }
 
     /**
-     * @brief   Clears loaded Document data.
-     *
+     * @brief   Create a filter accepting rows whose cell starts with a prefix.
+     * @param   pColumnName           column label name.
+     * @param   pPrefix               accepted prefix.
+     * @returns row filter.
      */
-    void Clear()
+    static RowFilter Prefix(const std::string& pColumnName, const std::string& pPrefix)
     {
-      mData.clear();
-      mColumnNames.clear();
-      mRowNames.clear();
-#ifdef HAS_CODECVT
-      mIsUtf16 = false;
-      mIsLE = false;
-#endif
-      mHasUtf8BOM = false;
+      return RowFilter(FilterPrefix, pColumnName, -1, { pPrefix });
     }
 
     /**
-     * @brief   Get column index by name.
-     * @param   pColumnName           column label name.
-     * @returns zero-based column index.
+     * @brief   Create a filter accepting rows whose cell starts with a prefix.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pPrefix               accepted prefix.
+     * @returns row filter.
      */
-    int GetColumnIdx(const std::string& pColumnName) const
+    static RowFilter Prefix(const size_t pColumnIdx, const std::string& pPrefix)
     {
-      if (mLabelParams.mColumnNameIdx >= 0)
-      {
-        if (mColumnNames.find(pColumnName) != mColumnNames.end())
-        {
-          return static_cast<int>(mColumnNames.at(pColumnName)) - (mLabelParams.mRowNameIdx + 1);
-        }
-      }
-      return -1;
+      return RowFilter(FilterPrefix, std::string(), static_cast<int>(pColumnIdx), { pPrefix });
     }
 
     /**
-     * @brief   Get column by index.
-     * @param   pColumnIdx            zero-based column index.
-     * @returns vector of column data.
+     * @brief   Create a filter accepting rows whose cell is lexicographically within a range,
+     *          e.g. ISO 8601 dates.
+     * @param   pColumnName           column label name.
+     * @param   pMin                  inclusive lower bound.
+     * @param   pMax                  inclusive upper bound.
+     * @returns row filter.
      */
-    template<typename T>
-    std::vector<T> GetColumn(const size_t pColumnIdx) const
+    static RowFilter TextRange(const std::string& pColumnName, const std::string& pMin, const std::string& pMax)
     {
-      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
-      std::vector<T> column;
-      Converter<T> converter(mConverterParams);
-      for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
-      {
-        if (std::distance(mData.begin(), itRow) > mLabelParams.mColumnNameIdx)
-        {
-          if (dataColumnIdx < itRow->size())
-          {
-            T val;
-            converter.ToVal(itRow->at(dataColumnIdx), val);
-            column.push_back(val);
-          }
-          else
-          {
-            const std::string errStr = "requested column index " +
-              std::to_string(pColumnIdx) + " >= " +
-              std::to_string(itRow->size() - GetDataColumnIndex(0)) +
-              " (number of columns on row index " +
-              std::to_string(std::distance(mData.begin(), itRow) -
-                             (mLabelParams.mColumnNameIdx + 1)) + ")";
-            throw std::out_of_range(errStr);
-          }
-        }
-      }
-      return column;
+      return RowFilter(FilterTextRange, pColumnName, -1, { pMin, pMax });
     }
 
     /**
-     * @brief   Get column by index.
+     * @brief   Create a filter accepting rows whose cell is lexicographically within a range,
+     *          e.g. ISO 8601 dates.
      * @param   pColumnIdx            zero-based column index.
-     * @param   pToVal                conversion function.
-     * @returns vector of column data.
+     * @param   pMin                  inclusive lower bound.
+     * @param   pMax                  inclusive upper bound.
+     * @returns row filter.
      */
-    template<typename T>
-    std::vector<T> GetColumn(const size_t pColumnIdx, ConvFunc<T> pToVal) const
+    static RowFilter TextRange(const size_t pColumnIdx, const std::string& pMin, const std::string& pMax)
     {
-      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
-      std::vector<T> column;
-      for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
-      {
-        if (std::distance(mData.begin(), itRow) > mLabelParams.mColumnNameIdx)
-        {
-          T val;
-          pToVal(itRow->at(dataColumnIdx), val);
-          column.push_back(val);
-        }
-      }
-      return column;
+      return RowFilter(FilterTextRange, std::string(), static_cast<int>(pColumnIdx), { pMin, pMax });
     }
 
     /**
-     * @brief   Get column by name.
+     * @brief   Create a filter accepting rows whose cell is a number within a range. Cells which
+     *          are not numbers are rejected.
      * @param   pColumnName           column label name.
-     * @returns vector of column data.
+     * @param   pMin                  inclusive lower bound.
+     * @param   pMax                  inclusive upper bound.
+     * @returns row filter.
      */
-    template<typename T>
-    std::vector<T> GetColumn(const std::string& pColumnName) const
+    static RowFilter NumericRange(const std::string& pColumnName, const long double pMin, const long double pMax)
     {
-      const int columnIdx = GetColumnIdx(pColumnName);
-      if (columnIdx < 0)
-      {
-        throw std::out_of_range("column not found: " + pColumnName);
-      }
-      return GetColumn<T>(static_cast<size_t>(columnIdx));
+      return RowFilter(FilterNumericRange, pColumnName, -1, { }, pMin, pMax);
     }
 
     /**
-     * @brief   Get column by name.
-     * @param   pColumnName           column label name.
-     * @param   pToVal                conversion function.
-     * @returns vector of column data.
+     * @brief   Create a filter accepting rows whose cell is a number within a range. Cells which
+     *          are not numbers are rejected.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pMin                  inclusive lower bound.
+     * @param   pMax                  inclusive upper bound.
+     * @returns row filter.
      */
-    template<typename T>
-    std::vector<T> GetColumn(const std::string& pColumnName, ConvFunc<T> pToVal) const
+    static RowFilter NumericRange(const size_t pColumnIdx, const long double pMin, const long double pMax)
     {
-      const int columnIdx = GetColumnIdx(pColumnName);
-      if (columnIdx < 0)
-      {
-        throw std::out_of_range("column not found: " + pColumnName);
-      }
-      return GetColumn<T>(static_cast<size_t>(columnIdx), pToVal);
+      return RowFilter(FilterNumericRange, std::string(), static_cast<int>(pColumnIdx), { }, pMin, pMax);
     }
 
     /**
-     * @brief   Set column by index.
-     * @param   pColumnIdx            zero-based column index.
-     * @param   pColumn               vector of column data.
+     * @brief   Check whether a cell satisfies the condition.
+     * @param   pCell                 cell data.
+     * @returns true if the row containing the cell should be kept.
      */
-    template<typename T>
-    void SetColumn(const size_t pColumnIdx, const std::vector<T>& pColumn)
+    bool Matches(const std::string& pCell) const
     {
-      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
-
-      while (GetDataRowIndex(pColumn.size()) > GetDataRowCount())
-      {
-        std::vector<std::string> row;
-        row.resize(GetDataColumnCount());
-        mData.push_back(row);
-      }
-
-      if ((dataColumnIdx + 1) > GetDataColumnCount())
+      switch (mType)
       {
-        for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+        case FilterEqual:
+          return pCell == mValues[0];
+        case FilterOneOf:
+          return std::binary_search(mValues.begin(), mValues.end(), pCell);
+        case FilterPrefix:
+          return pCell.compare(0, mValues[0].size(), mValues[0]) == 0;
+        case FilterTextRange:
+          return (mValues[0] <= pCell) && (pCell <= mValues[1]);
+        case FilterNumericRange:
         {
-          if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
+          if (pCell.empty())
           {
-            itRow->resize(GetDataColumnIndex(dataColumnIdx + 1));
+            return false;
           }
+          char* end = nullptr;
+          const long double val = std::strtold(pCell.c_str(), &end);
+          return (end == pCell.c_str() + pCell.size()) && (mMin <= val) && (val <= mMax);
         }
       }
-
-      Converter<T> converter(mConverterParams);
-      for (auto itRow = pColumn.begin(); itRow != pColumn.end(); ++itRow)
-      {
-        std::string str;
-        converter.ToStr(*itRow, str);
-        mData.at(static_cast<size_t>(std::distance(pColumn.begin(), itRow) + mLabelParams.mColumnNameIdx + 1)).at(
-          dataColumnIdx) = str;
-      }
+      return false;
     }
 
     /**
-     * @brief   Set column by name.
-     * @param   pColumnName           column label name.
-     * @param   pColumn               vector of column data.
+     * @brief   specifies the kind of condition.
      */
-    template<typename T>
-    void SetColumn(const std::string& pColumnName, const std::vector<T>& pColumn)
-    {
-      const int columnIdx = GetColumnIdx(pColumnName);
-      if (columnIdx < 0)
-      {
-        throw std::out_of_range("column not found: " + pColumnName);
-      }
-      SetColumn<T>(static_cast<size_t>(columnIdx), pColumn);
-    }
+    FilterType mType;
 
     /**
-     * @brief   Remove column by index.
-     * @param   pColumnIdx            zero-based column index.
+     * @brief   specifies the column label name (used when mColumnIdx < 0).
      */
-    void RemoveColumn(const size_t pColumnIdx)
-    {
-      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
-      for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
-      {
-        if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
-        {
-          itRow->erase(itRow->begin() + static_cast<int>(dataColumnIdx));
-        }
-      }
+    std::string mColumnName;
 
-      UpdateColumnNames();
-    }
+    /**
+     * @brief   specifies the zero-based column index, or -1 to look up the column by name.
+     */
+    int mColumnIdx;
 
     /**
-     * @brief   Remove column by name.
-     * @param   pColumnName           column label name.
+     * @brief   specifies the compared values (sorted for FilterOneOf).
      */
-    void RemoveColumn(const std::string& pColumnName)
-    {
-      int columnIdx = GetColumnIdx(pColumnName);
-      if (columnIdx < 0)
-      {
-        throw std::out_of_range("column not found: " + pColumnName);
-      }
+    std::vector<std::string> mValues;
 
-      RemoveColumn(static_cast<size_t>(columnIdx));
-    }
+    /**
+     * @brief   specifies the inclusive lower bound of FilterNumericRange.
+     */
+    long double mMin;
 
     /**
-     * @brief   Insert column at specified index.
-     * @param   pColumnIdx            zero-based column index.
-     * @param   pColumn               vector of column data (optional argument).
-     * @param   pColumnName           column label name (optional argument).
+     * @brief   specifies the inclusive upper bound of FilterNumericRange.
      */
-    template<typename T>
-    void InsertColumn(const size_t pColumnIdx, const std::vector<T>& pColumn = std::vector<T>(),
-                      const std::string& pColumnName = std::string())
+    long double mMax;
+  };
+
+  /**
+   * @brief     Datastructure holding parameters controlling which rows are kept when reading
+   *            a Document.
+   */
+  struct FilterParams
+  {
+    /**
+     * @brief   Constructor
+     * @param   pFilters              specifies the conditions a data row must satisfy (all of them)
+     *                                to be kept. Each condition is checked as soon as the cell of
+     *                                its column is parsed, and the remaining cells of a rejected row
+     *                                are not stored. Label rows are never filtered. Default: none
+     */
+    explicit FilterParams(const std::vector<RowFilter>& pFilters = std::vector<RowFilter>())
+      : mFilters(pFilters)
     {
-      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+    }
 
-      std::vector<std::string> column;
-      if (pColumn.empty())
-      {
-        column.resize(GetDataRowCount());
-      }
-      else
-      {
-        column.resize(GetDataRowIndex(pColumn.size()));
-        Converter<T> converter(mConverterParams);
-        for (auto itRow = pColumn.begin(); itRow != pColumn.end(); ++itRow)
-        {
-          std::string str;
-          converter.ToStr(*itRow, str);
-          const size_t rowIdx =
-            static_cast<size_t>(std::distance(pColumn.begin(), itRow) + (mLabelParams.mColumnNameIdx + 1));
-          column.at(rowIdx) = str;
-        }
-      }
+    /**
+     * @brief   specifies the conditions a data row must satisfy to be kept.
+     */
+    std::vector<RowFilter> mFilters;
+  };
 
-      while (column.size() > GetDataRowCount())
+  /**
+   * @brief     Datastructure holding parameters controlling lazy (on-demand) row parsing done
+   *            by LazyDocument.
+   */
+  struct LazyParams
+  {
+    /**
+     * @brief   Constructor
+     * @param   pCacheRows            specifies the maximum number of recently parsed rows kept in
+     *                                the LRU row cache. Default: 1024
+     * @param   pIndexPath            specifies an optional path of a file used to persist the
+     *                                line-offset index. A valid index file is reused instead of
+     *                                scanning the CSV-file, otherwise it is (re)created after the
+     *                                scan. Default: empty (index is not persisted)
+     */
+    explicit LazyParams(const size_t pCacheRows = 1024,
+                        const std::string& pIndexPath = std::string())
+      : mCacheRows(pCacheRows)
+      , mIndexPath(pIndexPath)
+    {
+      if (mCacheRows == 0)
       {
-        std::vector<std::string> row;
-        const size_t columnCount = std::max<size_t>(static_cast<size_t>(mLabelParams.mColumnNameIdx + 1),
-                                                    GetDataColumnCount());
-        row.resize(columnCount);
-        mData.push_back(row);
+        throw std::out_of_range("invalid row cache size 0");
       }
+    }
 
-      for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
-      {
-        if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
-        {
-          const size_t rowIdx = static_cast<size_t>(std::distance(mData.begin(), itRow));
-          itRow->insert(itRow->begin() + static_cast<int>(dataColumnIdx), column.at(rowIdx));
-        }
-      }
+    /**
+     * @brief   specifies the maximum number of recently parsed rows kept in the row cache.
+     */
+    size_t mCacheRows;
 
-      if (!pColumnName.empty())
-      {
-        SetColumnName(pColumnIdx, pColumnName);
-      }
+    /**
+     * @brief   specifies the path of the persisted line-offset index (empty for none).
+     */
+    std::string mIndexPath;
+  };
 
-      UpdateColumnNames();
+  /**
+   * @brief     Datastructure describing an aggregate computed per group by Document::GroupBy.
+   */
+  struct GroupAggregate
+  {
+    /**
+     * @brief   Kind of aggregate.
+     */
+    enum AggregateType
+    {
+      AggregateCount,
+      AggregateSum,
+      AggregateMin,
+      AggregateMax
+    };
+
+    /**
+     * @brief   Constructor
+     * @param   pType                 specifies the kind of aggregate.
+     * @param   pColumnName           specifies the aggregated column label name (used when
+     *                                pColumnIdx < 0, ignored for AggregateCount).
+     * @param   pColumnIdx            specifies the zero-based aggregated column index, or -1 to look
+     *                                up the column by pColumnName.
+     */
+    explicit GroupAggregate(const AggregateType pType, const std::string& pColumnName = std::string(),
+                            const int pColumnIdx = -1)
+      : mType(pType)
+      , mColumnName(pColumnName)
+      , mColumnIdx(pColumnIdx)
+    {
     }
 
     /**
-     * @brief   Get number of data columns (excluding label columns).
-     * @returns column count.
+     * @brief   Create an aggregate counting the rows of each group.
+     * @returns group aggregate.
      */
-    size_t GetColumnCount() const
+    static GroupAggregate Count()
     {
-      const int count = static_cast<int>((mData.size() > 0) ? mData.at(0).size() : 0) -
-        (mLabelParams.mRowNameIdx + 1);
-      return (count >= 0) ? static_cast<size_t>(count) : 0;
+      return GroupAggregate(AggregateCount);
     }
 
     /**
-     * @brief   Get row index by name.
-     * @param   pRowName              row label name.
-     * @returns zero-based row index.
+     * @brief   Create an aggregate summing a numeric column.
+     * @param   pColumnName           column label name.
+     * @returns group aggregate.
      */
-    int GetRowIdx(const std::string& pRowName) const
+    static GroupAggregate Sum(const std::string& pColumnName)
     {
-      if (mLabelParams.mRowNameIdx >= 0)
-      {
-        if (mRowNames.find(pRowName) != mRowNames.end())
-        {
-          return static_cast<int>(mRowNames.at(pRowName)) - (mLabelParams.mColumnNameIdx + 1);
-        }
-      }
-      return -1;
+      return GroupAggregate(AggregateSum, pColumnName);
     }
 
     /**
-     * @brief   Get row by index.
-     * @param   pRowIdx               zero-based row index.
-     * @returns vector of row data.
+     * @brief   Create an aggregate summing a numeric column.
+     * @param   pColumnIdx            zero-based column index.
+     * @returns group aggregate.
      */
-    template<typename T>
-    std::vector<T> GetRow(const size_t pRowIdx) const
+    static GroupAggregate Sum(const size_t pColumnIdx)
     {
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
-      std::vector<T> row;
-      Converter<T> converter(mConverterParams);
-      for (auto itCol = mData.at(dataRowIdx).begin(); itCol != mData.at(dataRowIdx).end(); ++itCol)
-      {
-        if (std::distance(mData.at(dataRowIdx).begin(), itCol) > mLabelParams.mRowNameIdx)
-        {
-          T val;
-          converter.ToVal(*itCol, val);
-          row.push_back(val);
-        }
-      }
-      return row;
+      return GroupAggregate(AggregateSum, std::string(), static_cast<int>(pColumnIdx));
     }
 
     /**
-     * @brief   Get row by index.
-     * @param   pRowIdx               zero-based row index.
-     * @param   pToVal                conversion function.
-     * @returns vector of row data.
+     * @brief   Create an aggregate computing the minimum of a numeric column.
+     * @param   pColumnName           column label name.
+     * @returns group aggregate.
      */
-    template<typename T>
-    std::vector<T> GetRow(const size_t pRowIdx, ConvFunc<T> pToVal) const
+    static GroupAggregate Min(const std::string& pColumnName)
     {
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
-      std::vector<T> row;
-      Converter<T> converter(mConverterParams);
-      for (auto itCol = mData.at(dataRowIdx).begin(); itCol != mData.at(dataRowIdx).end(); ++itCol)
-      {
-        if (std::distance(mData.at(dataRowIdx).begin(), itCol) > mLabelParams.mRowNameIdx)
-        {
-          T val;
-          pToVal(*itCol, val);
-          row.push_back(val);
-        }
-      }
-      return row;
+      return GroupAggregate(AggregateMin, pColumnName);
     }
 
     /**
-     * @brief   Get row by name.
-     * @param   pRowName              row label name.
-     * @returns vector of row data.
+     * @brief   Create an aggregate computing the minimum of a numeric column.
+     * @param   pColumnIdx            zero-based column index.
+     * @returns group aggregate.
      */
-    template<typename T>
-    std::vector<T> GetRow(const std::string& pRowName) const
+    static GroupAggregate Min(const size_t pColumnIdx)
     {
-      int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
-      {
-        throw std::out_of_range("row not found: " + pRowName);
-      }
-      return GetRow<T>(static_cast<size_t>(rowIdx));
+      return GroupAggregate(AggregateMin, std::string(), static_cast<int>(pColumnIdx));
     }
 
     /**
-     * @brief   Get row by name.
-     * @param   pRowName              row label name.
-     * @param   pToVal                conversion function.
-     * @returns vector of row data.
+     * @brief   Create an aggregate computing the maximum of a numeric column.
+     * @param   pColumnName           column label name.
+     * @returns group aggregate.
      */
-    template<typename T>
-    std::vector<T> GetRow(const std::string& pRowName, ConvFunc<T> pToVal) const
+    static GroupAggregate Max(const std::string& pColumnName)
     {
-      int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
-      {
-        throw std::out_of_range("row not found: " + pRowName);
-      }
-      return GetRow<T>(static_cast<size_t>(rowIdx), pToVal);
+      return GroupAggregate(AggregateMax, pColumnName);
     }
 
     /**
-     * @brief   Set row by index.
-     * @param   pRowIdx               zero-based row index.
-     * @param   pRow                  vector of row data.
+     * @brief   Create an aggregate computing the maximum of a numeric column.
+     * @param   pColumnIdx            zero-based column index.
+     * @returns group aggregate.
      */
-    template<typename T>
-    void SetRow(const size_t pRowIdx, const std::vector<T>& pRow)
+    static GroupAggregate Max(const size_t pColumnIdx)
     {
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+      return GroupAggregate(AggregateMax, std::string(), static_cast<int>(pColumnIdx));
+    }
 
-      while ((dataRowIdx + 1) > GetDataRowCount())
-      {
-        std::vector<std::string> row;
-        row.resize(GetDataColumnCount());
-        mData.push_back(row);
-      }
+    /**
+     * @brief   specifies the kind of aggregate.
+     */
+    AggregateType mType;
 
-      if (pRow.size() > GetDataColumnCount())
-      {
-        for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
-        {
-          if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
-          {
-            itRow->resize(GetDataColumnIndex(pRow.size()));
-          }
-        }
-      }
+    /**
+     * @brief   specifies the aggregated column label name (used when mColumnIdx < 0).
+     */
+    std::string mColumnName;
 
-      Converter<T> converter(mConverterParams);
-      for (auto itCol = pRow.begin(); itCol != pRow.end(); ++itCol)
-      {
-        std::string str;
-        converter.ToStr(*itCol, str);
-        mData.at(dataRowIdx).at(static_cast<size_t>(std::distance(pRow.begin(),
-                                                                  itCol) + mLabelParams.mRowNameIdx + 1)) = str;
-      }
+    /**
+     * @brief   specifies the zero-based aggregated column index, or -1 to look up the column by name.
+     */
+    int mColumnIdx;
+  };
+
+  /**
+   * @brief     Class holding the result of Document::GroupBy: one row per distinct key, in order
+   *            of first appearance, with the key cells, the number of rows and the aggregates of
+   *            each group. Key cells are stored in a single contiguous buffer.
+   */
+  class GroupTable
+  {
+  public:
+    /**
+     * @brief   Get number of groups.
+     * @returns group count.
+     */
+    size_t GetRowCount() const
+    {
+      return mCounts.size();
     }
 
     /**
-     * @brief   Set row by name.
-     * @param   pRowName              row label name.
-     * @param   pRow                  vector of row data.
+     * @brief   Get number of key columns.
+     * @returns key column count.
      */
-    template<typename T>
-    void SetRow(const std::string& pRowName, const std::vector<T>& pRow)
+    size_t GetColumnCount() const
     {
-      int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
-      {
-        throw std::out_of_range("row not found: " + pRowName);
-      }
-      return SetRow<T>(static_cast<size_t>(rowIdx), pRow);
+      return mKeyCount;
     }
 
     /**
-     * @brief   Remove row by index.
-     * @param   pRowIdx               zero-based row index.
+     * @brief   Get number of aggregates.
+     * @returns aggregate count.
      */
-    void RemoveRow(const size_t pRowIdx)
+    size_t GetAggregateCount() const
     {
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
-      mData.erase(mData.begin() + static_cast<int>(dataRowIdx));
-      UpdateRowNames();
+      return mAggregateCount;
     }
 
     /**
-     * @brief   Remove row by name.
-     * @param   pRowName              row label name.
+     * @brief   Get non-owning view of key cell.
+     * @param   pColumnIdx            zero-based key column index.
+     * @param   pRowIdx               zero-based group index.
+     * @returns view of key cell data.
      */
-    void RemoveRow(const std::string& pRowName)
+    std::string_view GetCellView(const size_t pColumnIdx, const size_t pRowIdx) const
     {
-      int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
+      if ((pColumnIdx >= mKeyCount) || (pRowIdx >= GetRowCount()))
       {
-        throw std::out_of_range("row not found: " + pRowName);
+        const std::string errStr = "requested key cell (" + std::to_string(pColumnIdx) + ", " +
+          std::to_string(pRowIdx) + ") out of range (" + std::to_string(mKeyCount) + " key columns, " +
+          std::to_string(GetRowCount()) + " groups)";
+        throw std::out_of_range(errStr);
       }
 
-      RemoveRow(static_cast<size_t>(rowIdx));
+      const size_t cellIdx = pRowIdx * mKeyCount + pColumnIdx;
+      return std::string_view(mKeyData).substr(mKeyOffsets[cellIdx], mKeyOffsets[cellIdx + 1] - mKeyOffsets[cellIdx]);
     }
 
     /**
-     * @brief   Insert row at specified index.
-     * @param   pRowIdx               zero-based row index.
-     * @param   pRow                  vector of row data (optional argument).
-     * @param   pRowName              row label name (optional argument).
+     * @brief   Get number of Document rows in a group.
+     * @param   pRowIdx               zero-based group index.
+     * @returns row count of the group.
+     */
+    long long GetCount(const size_t pRowIdx) const
+    {
+      return mCounts.at(pRowIdx);
+    }
+
+    /**
+     * @brief   Get aggregate value of a group.
+     * @param   pAggregateIdx         zero-based aggregate index (order of GroupBy aggregates).
+     * @param   pRowIdx               zero-based group index.
+     * @returns aggregate value.
+     */
+    long double GetValue(const size_t pAggregateIdx, const size_t pRowIdx) const
+    {
+      if ((pAggregateIdx >= mAggregateCount) || (pRowIdx >= GetRowCount()))
+      {
+        const std::string errStr = "requested aggregate (" + std::to_string(pAggregateIdx) + ", " +
+          std::to_string(pRowIdx) + ") out of range (" + std::to_string(mAggregateCount) + " aggregates, " +
+          std::to_string(GetRowCount()) + " groups)";
+        throw std::out_of_range(errStr);
+      }
+
+      return mValues[pRowIdx * mAggregateCount + pAggregateIdx];
+    }
+
+  private:
+    friend class Document;
+
+    size_t mKeyCount = 0;
+    size_t mAggregateCount = 0;
+    std::string mKeyData;
+    std::vector<size_t> mKeyOffsets;
+    std::vector<long long> mCounts;
+    std::vector<long double> mValues;
+  };
+
+  /**
+   * @brief     Lightweight non-owning range of the cells of one Document column. Cells are
+   *            exposed as std::string_view referring to the Document storage, so the view (and
+   *            the cells read from it) is invalidated by any modification or reload of the
+   *            Document.
+   */
+  class ColumnView
+  {
+  public:
+    /**
+     * @brief   Forward iterator over the cells of a ColumnView.
+     */
+    class Iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::string_view;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const std::string_view*;
+      using reference = std::string_view;
+
+      Iterator(const std::vector<std::string>* pRow, const size_t pColumnIdx)
+        : mRow(pRow)
+        , mColumnIdx(pColumnIdx)
+      {
+      }
+
+      std::string_view operator*() const
+      {
+        return mRow->at(mColumnIdx);
+      }
+
+      Iterator& operator++()
+      {
+        ++mRow;
+        return *this;
+      }
+
+      Iterator operator++(int)
+      {
+        Iterator it = *this;
+        ++mRow;
+        return it;
+      }
+
+      bool operator==(const Iterator& pOther) const
+      {
+        return mRow == pOther.mRow;
+      }
+
+      bool operator!=(const Iterator& pOther) const
+      {
+        return mRow != pOther.mRow;
+      }
+
+    private:
+      const std::vector<std::string>* mRow;
+      size_t mColumnIdx;
+    };
+
+    /**
+     * @brief   Constructor
+     * @param   pFirstRow             pointer to the first data row.
+     * @param   pRowCount             number of data rows.
+     * @param   pColumnIdx            zero-based column index within the stored rows (including
+     *                                label columns).
+     */
+    ColumnView(const std::vector<std::string>* pFirstRow, const size_t pRowCount, const size_t pColumnIdx)
+      : mFirstRow(pFirstRow)
+      , mRowCount(pRowCount)
+      , mColumnIdx(pColumnIdx)
+    {
+    }
+
+    /**
+     * @brief   Get cell by row index.
+     * @param   pRowIdx               zero-based row index.
+     * @returns view of the cell data.
+     */
+    std::string_view operator[](const size_t pRowIdx) const
+    {
+      return mFirstRow[pRowIdx].at(mColumnIdx);
+    }
+
+    /**
+     * @brief   Get number of cells in the view.
+     * @returns cell count.
+     */
+    size_t size() const
+    {
+      return mRowCount;
+    }
+
+    /**
+     * @brief   Check whether the view has no cells.
+     * @returns true if the view is empty.
+     */
+    bool empty() const
+    {
+      return mRowCount == 0;
+    }
+
+    /**
+     * @brief   Get iterator to the first cell.
+     * @returns iterator.
+     */
+    Iterator begin() const
+    {
+      return Iterator(mFirstRow, mColumnIdx);
+    }
+
+    /**
+     * @brief   Get iterator past the last cell.
+     * @returns iterator.
+     */
+    Iterator end() const
+    {
+      return Iterator(mFirstRow + mRowCount, mColumnIdx);
+    }
+
+  private:
+    const std::vector<std::string>* mFirstRow;
+    size_t mRowCount;
+    size_t mColumnIdx;
+  };
+
+  /**
+   * @brief     Class representing a CSV document.
+   */
+  class Document
+  {
+  public:
+    /**
+     * @brief   Constructor
+     * @param   pPath                 specifies the path of an existing CSV-file to populate the Document
+     *                                data with.
+     * @param   pLabelParams          specifies which row and column should be treated as labels.
+     * @param   pSeparatorParams      specifies which field and row separators should be used.
+     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
+     *                                handled.
+     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @param   pFilterParams         specifies which data rows are kept.
+     */
+    explicit Document(const std::string& pPath = std::string(),
+                      const LabelParams& pLabelParams = LabelParams(),
+                      const SeparatorParams& pSeparatorParams = SeparatorParams(),
+                      const ConverterParams& pConverterParams = ConverterParams(),
+                      const LineReaderParams& pLineReaderParams = LineReaderParams(),
+                      const FilterParams& pFilterParams = FilterParams())
+      : mPath(pPath)
+      , mLabelParams(pLabelParams)
+      , mSeparatorParams(pSeparatorParams)
+      , mConverterParams(pConverterParams)
+      , mLineReaderParams(pLineReaderParams)
+      , mFilterParams(pFilterParams)
+      , mData()
+      , mColumnNames()
+      , mRowNames()
+    {
+      if (!mPath.empty())
+      {
+        ReadCsv();
+      }
+    }
+
+    /**
+     * @brief   Constructor
+     * @param   pStream               specifies a binary input stream to read CSV data from.
+     * @param   pLabelParams          specifies which row and column should be treated as labels.
+     * @param   pSeparatorParams      specifies which field and row separators should be used.
+     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
+     *                                handled.
+     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @param   pFilterParams         specifies which data rows are kept.
+     */
+    explicit Document(std::istream& pStream,
+                      const LabelParams& pLabelParams = LabelParams(),
+                      const SeparatorParams& pSeparatorParams = SeparatorParams(),
+                      const ConverterParams& pConverterParams = ConverterParams(),
+                      const LineReaderParams& pLineReaderParams = LineReaderParams(),
+                      const FilterParams& pFilterParams = FilterParams())
+      : mPath()
+      , mLabelParams(pLabelParams)
+      , mSeparatorParams(pSeparatorParams)
+      , mConverterParams(pConverterParams)
+      , mLineReaderParams(pLineReaderParams)
+      , mFilterParams(pFilterParams)
+      , mData()
+      , mColumnNames()
+      , mRowNames()
+    {
+      ReadCsv(pStream);
+    }
+
+    /**
+     * @brief   Read Document data from file.
+     * @param   pPath                 specifies the path of an existing CSV-file to populate the Document
+     *                                data with.
+     * @param   pLabelParams          specifies which row and column should be treated as labels.
+     * @param   pSeparatorParams      specifies which field and row separators should be used.
+     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
+     *                                handled.
+     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @param   pFilterParams         specifies which data rows are kept.
+     */
+    void Load(const std::string& pPath,
+              const LabelParams& pLabelParams = LabelParams(),
+              const SeparatorParams& pSeparatorParams = SeparatorParams(),
+              const ConverterParams& pConverterParams = ConverterParams(),
+              const LineReaderParams& pLineReaderParams = LineReaderParams(),
+              const FilterParams& pFilterParams = FilterParams())
+    {
+      mPath = pPath;
+      mLabelParams = pLabelParams;
+      mSeparatorParams = pSeparatorParams;
+      mConverterParams = pConverterParams;
+      mLineReaderParams = pLineReaderParams;
+      mFilterParams = pFilterParams;
+      ReadCsv();
+    }
+
+    /**
+     * @brief   Read Document data from stream.
+     * @param   pStream               specifies a binary input stream to read CSV data from.
+     * @param   pLabelParams          specifies which row and column should be treated as labels.
+     * @param   pSeparatorParams      specifies which field and row separators should be used.
+     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
+     *                                handled.
+     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @param   pFilterParams         specifies which data rows are kept.
+     */
+    void Load(std::istream& pStream,
+              const LabelParams& pLabelParams = LabelParams(),
+              const SeparatorParams& pSeparatorParams = SeparatorParams(),
+              const ConverterParams& pConverterParams = ConverterParams(),
+              const LineReaderParams& pLineReaderParams = LineReaderParams(),
+              const FilterParams& pFilterParams = FilterParams())
+    {
+      mPath = "";
+      mLabelParams = pLabelParams;
+      mSeparatorParams = pSeparatorParams;
+      mConverterParams = pConverterParams;
+      mLineReaderParams = pLineReaderParams;
+      mFilterParams = pFilterParams;
+      ReadCsv(pStream);
+    }
+
+    /**
+     * @brief   Write Document data to file.
+     * @param   pPath                 optionally specifies the path where the CSV-file will be created
+     *                                (if not specified, the original path provided when creating or
+     *                                loading the Document data will be used).
+     */
+    void Save(const std::string& pPath = std::string())
+    {
+      if (!pPath.empty())
+      {
+        mPath = pPath;
+      }
+      WriteCsv();
+    }
+
+    /**
+     * @brief   Write Document data to stream.
+     * @param   pStream               specifies a binary output stream to write the data to.
+     */
+    void Save(std::ostream& pStream) const
+    {
+      WriteCsv(pStream);
+    }
+
+    /**
+     * @brief   Clears loaded Document data.
+     *
+     */
+    void Clear()
+    {
+      mData.clear();
+      mColumnNames.clear();
+      mRowNames.clear();
+#ifdef HAS_CODECVT
+      mIsUtf16 = false;
+      mIsLE = false;
+#endif
+      mHasUtf8BOM = false;
+    }
+
+    /**
+     * @brief   Get column index by name.
+     * @param   pColumnName           column label name.
+     * @returns zero-based column index.
+     */
+    int GetColumnIdx(const std::string& pColumnName) const
+    {
+      if (mLabelParams.mColumnNameIdx >= 0)
+      {
+        if (mColumnNames.find(pColumnName) != mColumnNames.end())
+        {
+          return static_cast<int>(mColumnNames.at(pColumnName)) - (mLabelParams.mRowNameIdx + 1);
+        }
+      }
+      return -1;
+    }
+
+    /**
+     * @brief   Get column by index.
+     * @param   pColumnIdx            zero-based column index.
+     * @returns vector of column data.
      */
     template<typename T>
-    void InsertRow(const size_t pRowIdx, const std::vector<T>& pRow = std::vector<T>(),
-                   const std::string& pRowName = std::string())
+    std::vector<T> GetColumn(const size_t pColumnIdx) const
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      std::vector<T> column;
+      Converter<T> converter(mConverterParams);
+      for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+      {
+        if (std::distance(mData.begin(), itRow) > mLabelParams.mColumnNameIdx)
+        {
+          if (dataColumnIdx < itRow->size())
+          {
+            T val;
+            converter.ToVal(itRow->at(dataColumnIdx), val);
+            column.push_back(val);
+          }
+          else
+          {
+            const std::string errStr = "requested column index " +
+              std::to_string(pColumnIdx) + " >= " +
+              std::to_string(itRow->size() - GetDataColumnIndex(0)) +
+              " (number of columns on row index " +
+              std::to_string(std::distance(mData.begin(), itRow) -
+                             (mLabelParams.mColumnNameIdx + 1)) + ")";
+            throw std::out_of_range(errStr);
+          }
+        }
+      }
+      return column;
+    }
+
+    /**
+     * @brief   Get column by index.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pToVal                conversion function.
+     * @returns vector of column data.
+     */
+    template<typename T>
+    std::vector<T> GetColumn(const size_t pColumnIdx, ConvFunc<T> pToVal) const
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      std::vector<T> column;
+      for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+      {
+        if (std::distance(mData.begin(), itRow) > mLabelParams.mColumnNameIdx)
+        {
+          T val;
+          pToVal(itRow->at(dataColumnIdx), val);
+          column.push_back(val);
+        }
+      }
+      return column;
+    }
+
+    /**
+     * @brief   Get column by name.
+     * @param   pColumnName           column label name.
+     * @returns vector of column data.
+     */
+    template<typename T>
+    std::vector<T> GetColumn(const std::string& pColumnName) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+      return GetColumn<T>(static_cast<size_t>(columnIdx));
+    }
+
+    /**
+     * @brief   Get column by name.
+     * @param   pColumnName           column label name.
+     * @param   pToVal                conversion function.
+     * @returns vector of column data.
+     */
+    template<typename T>
+    std::vector<T> GetColumn(const std::string& pColumnName, ConvFunc<T> pToVal) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+      return GetColumn<T>(static_cast<size_t>(columnIdx), pToVal);
+    }
+
+    /**
+     * @brief   Get non-owning view of column by index. No cell data is copied; the view is
+     *          invalidated by any modification of the Document.
+     * @param   pColumnIdx            zero-based column index.
+     * @returns view of column data.
+     */
+    ColumnView GetColumnView(const size_t pColumnIdx) const
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      const size_t firstDataRow = GetDataRowIndex(0);
+      if (mData.size() <= firstDataRow)
+      {
+        return ColumnView(nullptr, 0, dataColumnIdx);
+      }
+
+      return ColumnView(mData.data() + firstDataRow, mData.size() - firstDataRow, dataColumnIdx);
+    }
+
+    /**
+     * @brief   Get non-owning view of column by name.
+     * @param   pColumnName           column label name.
+     * @returns view of column data.
+     */
+    ColumnView GetColumnView(const std::string& pColumnName) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+      return GetColumnView(static_cast<size_t>(columnIdx));
+    }
+
+    /**
+     * @brief   Set column by index.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pColumn               vector of column data.
+     */
+    template<typename T>
+    void SetColumn(const size_t pColumnIdx, const std::vector<T>& pColumn)
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+
+      while (GetDataRowIndex(pColumn.size()) > GetDataRowCount())
+      {
+        std::vector<std::string> row;
+        row.resize(GetDataColumnCount());
+        mData.push_back(row);
+      }
+
+      if ((dataColumnIdx + 1) > GetDataColumnCount())
+      {
+        for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+        {
+          if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
+          {
+            itRow->resize(GetDataColumnIndex(dataColumnIdx + 1));
+          }
+        }
+      }
+
+      Converter<T> converter(mConverterParams);
+      for (auto itRow = pColumn.begin(); itRow != pColumn.end(); ++itRow)
+      {
+        std::string str;
+        converter.ToStr(*itRow, str);
+        mData.at(static_cast<size_t>(std::distance(pColumn.begin(), itRow) + mLabelParams.mColumnNameIdx + 1)).at(
+          dataColumnIdx) = str;
+      }
+    }
+
+    /**
+     * @brief   Set column by name.
+     * @param   pColumnName           column label name.
+     * @param   pColumn               vector of column data.
+     */
+    template<typename T>
+    void SetColumn(const std::string& pColumnName, const std::vector<T>& pColumn)
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+      SetColumn<T>(static_cast<size_t>(columnIdx), pColumn);
+    }
+
+    /**
+     * @brief   Remove column by index.
+     * @param   pColumnIdx            zero-based column index.
+     */
+    void RemoveColumn(const size_t pColumnIdx)
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+      {
+        if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
+        {
+          itRow->erase(itRow->begin() + static_cast<int>(dataColumnIdx));
+        }
+      }
+
+      UpdateColumnNames();
+    }
+
+    /**
+     * @brief   Remove column by name.
+     * @param   pColumnName           column label name.
+     */
+    void RemoveColumn(const std::string& pColumnName)
+    {
+      int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      RemoveColumn(static_cast<size_t>(columnIdx));
+    }
+
+    /**
+     * @brief   Insert column at specified index.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pColumn               vector of column data (optional argument).
+     * @param   pColumnName           column label name (optional argument).
+     */
+    template<typename T>
+    void InsertColumn(const size_t pColumnIdx, const std::vector<T>& pColumn = std::vector<T>(),
+                      const std::string& pColumnName = std::string())
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+
+      std::vector<std::string> column;
+      if (pColumn.empty())
+      {
+        column.resize(GetDataRowCount());
+      }
+      else
+      {
+        column.resize(GetDataRowIndex(pColumn.size()));
+        Converter<T> converter(mConverterParams);
+        for (auto itRow = pColumn.begin(); itRow != pColumn.end(); ++itRow)
+        {
+          std::string str;
+          converter.ToStr(*itRow, str);
+          const size_t rowIdx =
+            static_cast<size_t>(std::distance(pColumn.begin(), itRow) + (mLabelParams.mColumnNameIdx + 1));
+          column.at(rowIdx) = str;
+        }
+      }
+
+      while (column.size() > GetDataRowCount())
+      {
+        std::vector<std::string> row;
+        const size_t columnCount = std::max<size_t>(static_cast<size_t>(mLabelParams.mColumnNameIdx + 1),
+                                                    GetDataColumnCount());
+        row.resize(columnCount);
+        mData.push_back(row);
+      }
+
+      for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+      {
+        if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
+        {
+          const size_t rowIdx = static_cast<size_t>(std::distance(mData.begin(), itRow));
+          itRow->insert(itRow->begin() + static_cast<int>(dataColumnIdx), column.at(rowIdx));
+        }
+      }
+
+      if (!pColumnName.empty())
+      {
+        SetColumnName(pColumnIdx, pColumnName);
+      }
+
+      UpdateColumnNames();
+    }
+
+    /**
+     * @brief   Get number of data columns (excluding label columns).
+     * @returns column count.
+     */
+    size_t GetColumnCount() const
+    {
+      const int count = static_cast<int>((mData.size() > 0) ? mData.at(0).size() : 0) -
+        (mLabelParams.mRowNameIdx + 1);
+      return (count >= 0) ? static_cast<size_t>(count) : 0;
+    }
+
+    /**
+     * @brief   Get row index by name.
+     * @param   pRowName              row label name.
+     * @returns zero-based row index.
+     */
+    int GetRowIdx(const std::string& pRowName) const
+    {
+      if (mLabelParams.mRowNameIdx >= 0)
+      {
+        if (mRowNames.find(pRowName) != mRowNames.end())
+        {
+          return static_cast<int>(mRowNames.at(pRowName)) - (mLabelParams.mColumnNameIdx + 1);
+        }
+      }
+      return -1;
+    }
+
+    /**
+     * @brief   Get row by index.
+     * @param   pRowIdx               zero-based row index.
+     * @returns vector of row data.
+     */
+    template<typename T>
+    std::vector<T> GetRow(const size_t pRowIdx) const
+    {
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+      std::vector<T> row;
+      Converter<T> converter(mConverterParams);
+      for (auto itCol = mData.at(dataRowIdx).begin(); itCol != mData.at(dataRowIdx).end(); ++itCol)
+      {
+        if (std::distance(mData.at(dataRowIdx).begin(), itCol) > mLabelParams.mRowNameIdx)
+        {
+          T val;
+          converter.ToVal(*itCol, val);
+          row.push_back(val);
+        }
+      }
+      return row;
+    }
+
+    /**
+     * @brief   Get row by index.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pToVal                conversion function.
+     * @returns vector of row data.
+     */
+    template<typename T>
+    std::vector<T> GetRow(const size_t pRowIdx, ConvFunc<T> pToVal) const
+    {
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+      std::vector<T> row;
+      Converter<T> converter(mConverterParams);
+      for (auto itCol = mData.at(dataRowIdx).begin(); itCol != mData.at(dataRowIdx).end(); ++itCol)
+      {
+        if (std::distance(mData.at(dataRowIdx).begin(), itCol) > mLabelParams.mRowNameIdx)
+        {
+          T val;
+          pToVal(*itCol, val);
+          row.push_back(val);
+        }
+      }
+      return row;
+    }
+
+    /**
+     * @brief   Get row by name.
+     * @param   pRowName              row label name.
+     * @returns vector of row data.
+     */
+    template<typename T>
+    std::vector<T> GetRow(const std::string& pRowName) const
+    {
+      int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+      return GetRow<T>(static_cast<size_t>(rowIdx));
+    }
+
+    /**
+     * @brief   Get row by name.
+     * @param   pRowName              row label name.
+     * @param   pToVal                conversion function.
+     * @returns vector of row data.
+     */
+    template<typename T>
+    std::vector<T> GetRow(const std::string& pRowName, ConvFunc<T> pToVal) const
+    {
+      int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+      return GetRow<T>(static_cast<size_t>(rowIdx), pToVal);
+    }
+
+    /**
+     * @brief   Get non-owning view of row by index. No cell data is copied; the view is
+     *          invalidated by any modification of the Document.
+     * @param   pRowIdx               zero-based row index.
+     * @returns span of row data (excluding label columns).
+     */
+    std::span<const std::string> GetRowView(const size_t pRowIdx) const
+    {
+      const std::vector<std::string>& row = mData.at(GetDataRowIndex(pRowIdx));
+      const size_t firstDataColumn = std::min(GetDataColumnIndex(0), row.size());
+      return std::span<const std::string>(row.data() + firstDataColumn, row.size() - firstDataColumn);
+    }
+
+    /**
+     * @brief   Get non-owning view of row by name.
+     * @param   pRowName              row label name.
+     * @returns span of row data (excluding label columns).
+     */
+    std::span<const std::string> GetRowView(const std::string& pRowName) const
+    {
+      int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+      return GetRowView(static_cast<size_t>(rowIdx));
+    }
+
+    /**
+     * @brief   Set row by index.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pRow                  vector of row data.
+     */
+    template<typename T>
+    void SetRow(const size_t pRowIdx, const std::vector<T>& pRow)
+    {
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+
+      while ((dataRowIdx + 1) > GetDataRowCount())
+      {
+        std::vector<std::string> row;
+        row.resize(GetDataColumnCount());
+        mData.push_back(row);
+      }
+
+      if (pRow.size() > GetDataColumnCount())
+      {
+        for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+        {
+          if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
+          {
+            itRow->resize(GetDataColumnIndex(pRow.size()));
+          }
+        }
+      }
+
+      Converter<T> converter(mConverterParams);
+      for (auto itCol = pRow.begin(); itCol != pRow.end(); ++itCol)
+      {
+        std::string str;
+        converter.ToStr(*itCol, str);
+        mData.at(dataRowIdx).at(static_cast<size_t>(std::distance(pRow.begin(),
+                                                                  itCol) + mLabelParams.mRowNameIdx + 1)) = str;
+      }
+    }
+
+    /**
+     * @brief   Set row by name.
+     * @param   pRowName              row label name.
+     * @param   pRow                  vector of row data.
+     */
+    template<typename T>
+    void SetRow(const std::string& pRowName, const std::vector<T>& pRow)
+    {
+      int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+      return SetRow<T>(static_cast<size_t>(rowIdx), pRow);
+    }
+
+    /**
+     * @brief   Remove row by index.
+     * @param   pRowIdx               zero-based row index.
+     */
+    void RemoveRow(const size_t pRowIdx)
+    {
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+      mData.erase(mData.begin() + static_cast<int>(dataRowIdx));
+      UpdateRowNames();
+    }
+
+    /**
+     * @brief   Remove row by name.
+     * @param   pRowName              row label name.
+     */
+    void RemoveRow(const std::string& pRowName)
+    {
+      int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      RemoveRow(static_cast<size_t>(rowIdx));
+    }
+
+    /**
+     * @brief   Insert row at specified index.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pRow                  vector of row data (optional argument).
+     * @param   pRowName              row label name (optional argument).
+     */
+    template<typename T>
+    void InsertRow(const size_t pRowIdx, const std::vector<T>& pRow = std::vector<T>(),
+                   const std::string& pRowName = std::string())
+    {
+      const size_t rowIdx = GetDataRowIndex(pRowIdx);
+
+      std::vector<std::string> row;
+      if (pRow.empty())
+      {
+        row.resize(GetDataColumnCount());
+      }
+      else
+      {
+        row.resize(GetDataColumnIndex(pRow.size()));
+        Converter<T> converter(mConverterParams);
+        for (auto itCol = pRow.begin(); itCol != pRow.end(); ++itCol)
+        {
+          std::string str;
+          converter.ToStr(*itCol, str);
+          row.at(static_cast<size_t>(std::distance(pRow.begin(), itCol) + mLabelParams.mRowNameIdx + 1)) = str;
+        }
+      }
+
+      while (rowIdx > GetDataRowCount())
+      {
+        std::vector<std::string> tempRow;
+        tempRow.resize(GetDataColumnCount());
+        mData.push_back(tempRow);
+      }
+
+      mData.insert(mData.begin() + static_cast<int>(rowIdx), row);
+
+      if (!pRowName.empty())
+      {
+        SetRowName(pRowIdx, pRowName);
+      }
+
+      UpdateRowNames();
+    }
+
+    /**
+     * @brief   Get number of data rows (excluding label rows).
+     * @returns row count.
+     */
+    size_t GetRowCount() const
+    {
+      const int count = static_cast<int>(mData.size()) - (mLabelParams.mColumnNameIdx + 1);
+      return (count >= 0) ? static_cast<size_t>(count) : 0;
+    }
+
+    /**
+     * @brief   Get cell by index.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pRowIdx               zero-based row index.
+     * @returns cell data.
+     */
+    template<typename T>
+    T GetCell(const size_t pColumnIdx, const size_t pRowIdx) const
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+
+      T val;
+      Converter<T> converter(mConverterParams);
+      converter.ToVal(mData.at(dataRowIdx).at(dataColumnIdx), val);
+      return val;
+    }
+
+    /**
+     * @brief   Get cell by index.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pToVal                conversion function.
+     * @returns cell data.
+     */
+    template<typename T>
+    T GetCell(const size_t pColumnIdx, const size_t pRowIdx, ConvFunc<T> pToVal) const
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+
+      T val;
+      pToVal(mData.at(dataRowIdx).at(dataColumnIdx), val);
+      return val;
+    }
+
+    /**
+     * @brief   Get cell by name.
+     * @param   pColumnName           column label name.
+     * @param   pRowName              row label name.
+     * @returns cell data.
+     */
+    template<typename T>
+    T GetCell(const std::string& pColumnName, const std::string& pRowName) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      const int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      return GetCell<T>(static_cast<size_t>(columnIdx), static_cast<size_t>(rowIdx));
+    }
+
+    /**
+     * @brief   Get cell by name.
+     * @param   pColumnName           column label name.
+     * @param   pRowName              row label name.
+     * @param   pToVal                conversion function.
+     * @returns cell data.
+     */
+    template<typename T>
+    T GetCell(const std::string& pColumnName, const std::string& pRowName, ConvFunc<T> pToVal) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      const int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      return GetCell<T>(static_cast<size_t>(columnIdx), static_cast<size_t>(rowIdx), pToVal);
+    }
+
+    /**
+     * @brief   Get cell by column name and row index.
+     * @param   pColumnName           column label name.
+     * @param   pRowIdx               zero-based row index.
+     * @returns cell data.
+     */
+    template<typename T>
+    T GetCell(const std::string& pColumnName, const size_t pRowIdx) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      return GetCell<T>(static_cast<size_t>(columnIdx), pRowIdx);
+    }
+
+    /**
+     * @brief   Get cell by column name and row index.
+     * @param   pColumnName           column label name.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pToVal                conversion function.
+     * @returns cell data.
+     */
+    template<typename T>
+    T GetCell(const std::string& pColumnName, const size_t pRowIdx, ConvFunc<T> pToVal) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      return GetCell<T>(static_cast<size_t>(columnIdx), pRowIdx, pToVal);
+    }
+
+    /**
+     * @brief   Get cell by column index and row name.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pRowName              row label name.
+     * @returns cell data.
+     */
+    template<typename T>
+    T GetCell(const size_t pColumnIdx, const std::string& pRowName) const
+    {
+      const int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      return GetCell<T>(pColumnIdx, static_cast<size_t>(rowIdx));
+    }
+
+    /**
+     * @brief   Get cell by column index and row name.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pRowName              row label name.
+     * @param   pToVal                conversion function.
+     * @returns cell data.
+     */
+    template<typename T>
+    T GetCell(const size_t pColumnIdx, const std::string& pRowName, ConvFunc<T> pToVal) const
+    {
+      const int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      return GetCell<T>(pColumnIdx, static_cast<size_t>(rowIdx), pToVal);
+    }
+
+    /**
+     * @brief   Get non-owning view of cell by index. No cell data is copied; the view is
+     *          invalidated by any modification of the Document.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pRowIdx               zero-based row index.
+     * @returns view of cell data.
+     */
+    std::string_view GetCellView(const size_t pColumnIdx, const size_t pRowIdx) const
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+
+      return mData.at(dataRowIdx).at(dataColumnIdx);
+    }
+
+    /**
+     * @brief   Get non-owning view of cell by name.
+     * @param   pColumnName           column label name.
+     * @param   pRowName              row label name.
+     * @returns view of cell data.
+     */
+    std::string_view GetCellView(const std::string& pColumnName, const std::string& pRowName) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      const int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      return GetCellView(static_cast<size_t>(columnIdx), static_cast<size_t>(rowIdx));
+    }
+
+    /**
+     * @brief   Get non-owning view of cell by column name and row index.
+     * @param   pColumnName           column label name.
+     * @param   pRowIdx               zero-based row index.
+     * @returns view of cell data.
+     */
+    std::string_view GetCellView(const std::string& pColumnName, const size_t pRowIdx) const
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      return GetCellView(static_cast<size_t>(columnIdx), pRowIdx);
+    }
+
+    /**
+     * @brief   Get non-owning view of cell by column index and row name.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pRowName              row label name.
+     * @returns view of cell data.
+     */
+    std::string_view GetCellView(const size_t pColumnIdx, const std::string& pRowName) const
+    {
+      const int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      return GetCellView(pColumnIdx, static_cast<size_t>(rowIdx));
+    }
+
+    /**
+     * @brief   Set cell by index.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pCell                 cell data.
+     */
+    template<typename T>
+    void SetCell(const size_t pColumnIdx, const size_t pRowIdx, const T& pCell)
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+
+      while ((dataRowIdx + 1) > GetDataRowCount())
+      {
+        std::vector<std::string> row;
+        row.resize(GetDataColumnCount());
+        mData.push_back(row);
+      }
+
+      if ((dataColumnIdx + 1) > GetDataColumnCount())
+      {
+        for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+        {
+          if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
+          {
+            itRow->resize(dataColumnIdx + 1);
+          }
+        }
+      }
+
+      std::string str;
+      Converter<T> converter(mConverterParams);
+      converter.ToStr(pCell, str);
+      mData.at(dataRowIdx).at(dataColumnIdx) = str;
+    }
+
+    /**
+     * @brief   Set cell by name.
+     * @param   pColumnName           column label name.
+     * @param   pRowName              row label name.
+     * @param   pCell                 cell data.
+     */
+    template<typename T>
+    void SetCell(const std::string& pColumnName, const std::string& pRowName, const T& pCell)
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      const int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      SetCell<T>(static_cast<size_t>(columnIdx), static_cast<size_t>(rowIdx), pCell);
+    }
+
+    /**
+     * @brief   Set cell by column index and row name.
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pRowName              row label name.
+     * @param   pCell                 cell data.
+     */
+    template<typename T>
+    void SetCell(const size_t pColumnIdx, const std::string& pRowName, const T& pCell)
+    {
+      const int rowIdx = GetRowIdx(pRowName);
+      if (rowIdx < 0)
+      {
+        throw std::out_of_range("row not found: " + pRowName);
+      }
+
+      SetCell<T>(pColumnIdx, static_cast<size_t>(rowIdx), pCell);
+    }
+
+    /**
+     * @brief   Set cell by column name and row index.
+     * @param   pColumnName           column label name.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pCell                 cell data.
+     */
+    template<typename T>
+    void SetCell(const std::string& pColumnName, const size_t pRowIdx, const T& pCell)
+    {
+      const int columnIdx = GetColumnIdx(pColumnName);
+      if (columnIdx < 0)
+      {
+        throw std::out_of_range("column not found: " + pColumnName);
+      }
+
+      SetCell<T>(static_cast<size_t>(columnIdx), pRowIdx, pCell);
+    }
+
+    /**
+     * @brief   Group rows by key columns and compute aggregates per group. Keys are hashed as views
+     *          of the Document cells in an open-addressing table, so no key is copied until the
+     *          result is built.
+     * @param   pKeyColumnIdxs        zero-based indices of key columns.
+     * @param   pAggregates           aggregates computed per group (optional argument).
+     * @param   pThreads              number of threads splitting the rows between them; groups
+     *                                keep the order of first appearance regardless of the number
+     *                                of threads, sums may differ in rounding (default 1).
+     * @returns table of groups.
+     */
+    GroupTable GroupBy(const std::vector<size_t>& pKeyColumnIdxs,
+                       const std::vector<GroupAggregate>& pAggregates = std::vector<GroupAggregate>(),
+                       const size_t pThreads = 1) const
+    {
+      if (pKeyColumnIdxs.empty())
+      {
+        throw std::invalid_argument("no key columns");
+      }
+
+      std::vector<size_t> keyColumns;
+      for (const size_t columnIdx : pKeyColumnIdxs)
+      {
+        keyColumns.push_back(GetDataColumnIndex(columnIdx));
+      }
+
+      std::vector<int> aggregateColumns;
+      for (const GroupAggregate& aggregate : pAggregates)
+      {
+        int columnIdx = -1;
+        if (aggregate.mType != GroupAggregate::AggregateCount)
+        {
+          columnIdx = (aggregate.mColumnIdx >= 0) ? aggregate.mColumnIdx : GetColumnIdx(aggregate.mColumnName);
+          if (columnIdx < 0)
+          {
+            throw std::out_of_range("column not found: " + aggregate.mColumnName);
+          }
+          columnIdx = static_cast<int>(GetDataColumnIndex(static_cast<size_t>(columnIdx)));
+        }
+        aggregateColumns.push_back(columnIdx);
+      }
+
+      const size_t firstRow = std::min(GetDataRowIndex(0), mData.size());
+      const size_t rowCount = mData.size() - firstRow;
+      const size_t threads = std::max<size_t>(1, std::min(pThreads, rowCount));
+
+      std::vector<GroupState> states(threads);
+      std::vector<std::exception_ptr> errors(threads);
+      auto groupRows = [&](const size_t pPart)
+      {
+        try
+        {
+          GroupState& state = states[pPart];
+          const size_t begin = firstRow + rowCount * pPart / threads;
+          const size_t end = firstRow + rowCount * (pPart + 1) / threads;
+          for (size_t rowIdx = begin; rowIdx < end; ++rowIdx)
+          {
+            const size_t groupIdx = FindOrAddGroup(state, keyColumns, pAggregates, rowIdx, HashKey(keyColumns, rowIdx));
+            Accumulate(state, pAggregates, aggregateColumns, groupIdx, rowIdx);
+          }
+        }
+        catch (...)
+        {
+          errors[pPart] = std::current_exception();
+        }
+      };
+
+      if (threads == 1)
+      {
+        groupRows(0);
+      }
+      else
+      {
+        std::vector<std::thread> workers;
+        for (size_t part = 0; part < threads; ++part)
+        {
+          workers.emplace_back(groupRows, part);
+        }
+        for (std::thread& worker : workers)
+        {
+          worker.join();
+        }
+      }
+
+      for (const std::exception_ptr& error : errors)
+      {
+        if (error)
+        {
+          std::rethrow_exception(error);
+        }
+      }
+
+      // merge partial results in row order to keep the order of first appearance
+      GroupState& result = states[0];
+      for (size_t part = 1; part < threads; ++part)
+      {
+        const GroupState& state = states[part];
+        for (size_t groupIdx = 0; groupIdx < state.mFirstRows.size(); ++groupIdx)
+        {
+          const size_t resultIdx = FindOrAddGroup(result, keyColumns, pAggregates,
+                                                  state.mFirstRows[groupIdx], state.mHashes[groupIdx]);
+          Combine(result, pAggregates, resultIdx, state, groupIdx);
+        }
+      }
+
+      GroupTable table;
+      table.mKeyCount = keyColumns.size();
+      table.mAggregateCount = pAggregates.size();
+      table.mKeyOffsets.push_back(0);
+      for (const size_t rowIdx : result.mFirstRows)
+      {
+        for (const size_t columnIdx : keyColumns)
+        {
+          table.mKeyData += mData[rowIdx].at(columnIdx);
+          table.mKeyOffsets.push_back(table.mKeyData.size());
+        }
+      }
+      table.mCounts = std::move(result.mCounts);
+      table.mValues = std::move(result.mValues);
+      return table;
+    }
+
+    /**
+     * @brief   Group rows by key columns and compute aggregates per group.
+     * @param   pKeyColumnNames       label names of key columns.
+     * @param   pAggregates           aggregates computed per group (optional argument).
+     * @param   pThreads              number of threads splitting the rows between them (default 1).
+     * @returns table of groups.
+     */
+    GroupTable GroupBy(const std::vector<std::string>& pKeyColumnNames,
+                       const std::vector<GroupAggregate>& pAggregates = std::vector<GroupAggregate>(),
+                       const size_t pThreads = 1) const
+    {
+      std::vector<size_t> keyColumnIdxs;
+      for (const std::string& columnName : pKeyColumnNames)
+      {
+        const int columnIdx = GetColumnIdx(columnName);
+        if (columnIdx < 0)
+        {
+          throw std::out_of_range("column not found: " + columnName);
+        }
+        keyColumnIdxs.push_back(static_cast<size_t>(columnIdx));
+      }
+      return GroupBy(keyColumnIdxs, pAggregates, pThreads);
+    }
+
+    /**
+     * @brief   Get column name
+     * @param   pColumnIdx            zero-based column index.
+     * @returns column name.
+     */
+    std::string GetColumnName(const size_t pColumnIdx) const
+    {
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      if (mLabelParams.mColumnNameIdx < 0)
+      {
+        throw std::out_of_range("column name row index < 0: " + std::to_string(mLabelParams.mColumnNameIdx));
+      }
+
+      return mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).at(dataColumnIdx);
+    }
+
+    /**
+     * @brief   Set column name
+     * @param   pColumnIdx            zero-based column index.
+     * @param   pColumnName           column name.
+     */
+    void SetColumnName(size_t pColumnIdx, const std::string& pColumnName)
+    {
+      if (mLabelParams.mColumnNameIdx < 0)
+      {
+        throw std::out_of_range("column name row index < 0: " + std::to_string(mLabelParams.mColumnNameIdx));
+      }
+
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      mColumnNames[pColumnName] = dataColumnIdx;
+
+      // increase table size if necessary:
+      const size_t rowIdx = static_cast<size_t>(mLabelParams.mColumnNameIdx);
+      if (rowIdx >= mData.size())
+      {
+        mData.resize(rowIdx + 1);
+      }
+      auto& row = mData[rowIdx];
+      if (dataColumnIdx >= row.size())
+      {
+        row.resize(dataColumnIdx + 1);
+      }
+
+      mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).at(dataColumnIdx) = pColumnName;
+    }
+
+    /**
+     * @brief   Get column names
+     * @returns vector of column names.
+     */
+    std::vector<std::string> GetColumnNames() const
+    {
+      if (mLabelParams.mColumnNameIdx >= 0)
+      {
+        return std::vector<std::string>(mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).begin() +
+                                        (mLabelParams.mRowNameIdx + 1),
+                                        mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).end());
+      }
+
+      return std::vector<std::string>();
+    }
+
+    /**
+     * @brief   Get row name
+     * @param   pRowIdx               zero-based column index.
+     * @returns row name.
+     */
+    std::string GetRowName(const size_t pRowIdx) const
+    {
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+      if (mLabelParams.mRowNameIdx < 0)
+      {
+        throw std::out_of_range("row name column index < 0: " + std::to_string(mLabelParams.mRowNameIdx));
+      }
+
+      return mData.at(dataRowIdx).at(static_cast<size_t>(mLabelParams.mRowNameIdx));
+    }
+
+    /**
+     * @brief   Set row name
+     * @param   pRowIdx               zero-based row index.
+     * @param   pRowName              row name.
+     */
+    void SetRowName(size_t pRowIdx, const std::string& pRowName)
+    {
+      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+      mRowNames[pRowName] = dataRowIdx;
+      if (mLabelParams.mRowNameIdx < 0)
+      {
+        throw std::out_of_range("row name column index < 0: " + std::to_string(mLabelParams.mRowNameIdx));
+      }
+
+      // increase table size if necessary:
+      if (dataRowIdx >= mData.size())
+      {
+        mData.resize(dataRowIdx + 1);
+      }
+      auto& row = mData[dataRowIdx];
+      if (mLabelParams.mRowNameIdx >= static_cast<int>(row.size()))
+      {
+        row.resize(static_cast<size_t>(mLabelParams.mRowNameIdx) + 1);
+      }
+
+      mData.at(dataRowIdx).at(static_cast<size_t>(mLabelParams.mRowNameIdx)) = pRowName;
+    }
+
+    /**
+     * @brief   Get row names
+     * @returns vector of row names.
+     */
+    std::vector<std::string> GetRowNames() const
+    {
+      std::vector<std::string> rownames;
+      if (mLabelParams.mRowNameIdx >= 0)
+      {
+        for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+        {
+          if (std::distance(mData.begin(), itRow) > mLabelParams.mColumnNameIdx)
+          {
+            rownames.push_back(itRow->at(static_cast<size_t>(mLabelParams.mRowNameIdx)));
+          }
+        }
+      }
+      return rownames;
+    }
+
+  private:
+    void ReadCsv()
+    {
+      std::ifstream stream;
+      stream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+      stream.open(mPath, std::ios::binary);
+      ReadCsv(stream);
+    }
+
+    void ReadCsv(std::istream& pStream)
+    {
+      Clear();
+      pStream.seekg(0, std::ios::end);
+      std::streamsize length = pStream.tellg();
+      pStream.seekg(0, std::ios::beg);
+
+#ifdef HAS_CODECVT
+      std::vector<char> bom2b(2, '\0');
+      if (length >= 2)
+      {
+        pStream.read(bom2b.data(), 2);
+        pStream.seekg(0, std::ios::beg);
+      }
+
+      static const std::vector<char> bomU16le = { '\xff', '\xfe' };
+      static const std::vector<char> bomU16be = { '\xfe', '\xff' };
+      if ((bom2b == bomU16le) || (bom2b == bomU16be))
+      {
+        mIsUtf16 = true;
+        mIsLE = (bom2b == bomU16le);
+
+        std::wifstream wstream;
+        wstream.exceptions(std::wifstream::failbit | std::wifstream::badbit);
+        wstream.open(mPath, std::ios::binary);
+        if (mIsLE)
+        {
+          wstream.imbue(std::locale(wstream.getloc(),
+                                    new std::codecvt_utf16<wchar_t, 0x10ffff,
+                                                           static_cast<std::codecvt_mode>(std::consume_header |
+                                                                                          std::little_endian)>));
+        }
+        else
+        {
+          wstream.imbue(std::locale(wstream.getloc(),
+                                    new std::codecvt_utf16<wchar_t, 0x10ffff,
+                                                           std::consume_header>));
+        }
+        std::wstringstream wss;
+        wss << wstream.rdbuf();
+        std::string utf8 = ToString(wss.str());
+        std::stringstream ss(utf8);
+        ParseCsv(ss, static_cast<std::streamsize>(utf8.size()));
+      }
+      else
+#endif
+      {
+        // check for UTF-8 Byte order mark and skip it when found
+        if (length >= 3)
+        {
+          std::vector<char> bom3b(3, '\0');
+          pStream.read(bom3b.data(), 3);
+
+          if (bom3b != s_Utf8BOM)
+          {
+            // file does not start with a UTF-8 Byte order mark
+            pStream.seekg(0, std::ios::beg);
+          }
+          else
+          {
+            // file did start with a UTF-8 Byte order mark, simply skip it
+            length -= 3;
+            mHasUtf8BOM = true;
+          }
+        }
+
+        ParseCsv(pStream, length);
+      }
+    }
+
+    void ParseCsv(std::istream& pStream, std::streamsize p_FileLength)
+    {
+      const std::streamsize bufLength = 64 * 1024;
+      std::vector<char> buffer(bufLength);
+      std::vector<std::string> row;
+      std::string cell;
+      bool quoted = false;
+      int cr = 0;
+      int lf = 0;
+      RowFilterState filterState;
+
+      while (p_FileLength > 0)
+      {
+        const std::streamsize toReadLength = std::min<std::streamsize>(p_FileLength, bufLength);
+        pStream.read(buffer.data(), toReadLength);
+
+        // With user-specified istream opened in non-binary mode on windows, we may have a
+        // data length mismatch, so ensure we don't parse outside actual data length read.
+        const std::streamsize readLength = pStream.gcount();
+        if (readLength <= 0)
+        {
+          break;
+        }
+
+        for (size_t i = 0; i < static_cast<size_t>(readLength); ++i)
+        {
+          if (buffer[i] == mSeparatorParams.mQuoteChar)
+          {
+            if (cell.empty() || (cell[0] == mSeparatorParams.mQuoteChar))
+            {
+              quoted = !quoted;
+            }
+            else if (mSeparatorParams.mTrim)
+            {
+              // allow whitespace before first mQuoteChar
+              const auto firstQuote = std::find(cell.begin(), cell.end(), mSeparatorParams.mQuoteChar);
+              if (std::all_of(cell.begin(), firstQuote, [](int ch) { return isspace(ch); }))
+              {
+                quoted = !quoted;
+              }
+            }
+            cell += buffer[i];
+          }
+          else if (buffer[i] == mSeparatorParams.mSeparator)
+          {
+            if (!quoted)
+            {
+              PushCell(row, cell, filterState);
+              cell.clear();
+            }
+            else
+            {
+              cell += buffer[i];
+            }
+          }
+          else if (buffer[i] == '\r')
+          {
+            if (mSeparatorParams.mQuotedLinebreaks && quoted)
+            {
+              cell += buffer[i];
+            }
+            else
+            {
+              ++cr;
+            }
+          }
+          else if (buffer[i] == '\n')
+          {
+            if (mSeparatorParams.mQuotedLinebreaks && quoted)
+            {
+              cell += buffer[i];
+            }
+            else
+            {
+              ++lf;
+              if (mLineReaderParams.mSkipEmptyLines && row.empty() && cell.empty() &&
+                  (filterState.mCellCount == 0))
+              {
+                // skip empty line
+              }
+              else
+              {
+                PushCell(row, cell, filterState);
+
+                if (!IsRowAccepted(filterState))
+                {
+                  // skip filtered row
+                }
+                else if (mLineReaderParams.mSkipCommentLines && !row.at(0).empty() &&
+                         (row.at(0)[0] == mLineReaderParams.mCommentPrefix))
+                {
+                  // skip comment line
+                }
+                else
+                {
+                  mData.push_back(row);
+                }
+
+                cell.clear();
+                row.clear();
+                quoted = false;
+              }
+            }
+          }
+          else
+          {
+            cell += buffer[i];
+          }
+        }
+        p_FileLength -= readLength;
+      }
+
+      // Handle last row / cell without linebreak
+      if (row.empty() && cell.empty() && (filterState.mCellCount == 0))
+      {
+        // skip empty trailing line
+      }
+      else
+      {
+        PushCell(row, cell, filterState);
+
+        if (!IsRowAccepted(filterState))
+        {
+          // skip filtered row
+        }
+        else if (mLineReaderParams.mSkipCommentLines && !row.at(0).empty() &&
+                 (row.at(0)[0] == mLineReaderParams.mCommentPrefix))
+        {
+          // skip comment line
+        }
+        else
+        {
+          mData.push_back(row);
+        }
+
+        cell.clear();
+        row.clear();
+        quoted = false;
+      }
+
+      // Assume CR/LF if at least half the linebreaks have CR
+      mSeparatorParams.mHasCR = (cr > (lf / 2));
+
+      // Set up column labels
+      UpdateColumnNames();
+
+      // Set up row labels
+      UpdateRowNames();
+    }
+
+    struct RowFilterState
+    {
+      std::vector<std::vector<const RowFilter*>> mColumnFilters;
+      bool mResolved = false;
+      bool mRejected = false;
+      size_t mCellCount = 0;
+    };
+
+    void PushCell(std::vector<std::string>& pRow, const std::string& pCell, RowFilterState& pState) const
+    {
+      // label rows are never filtered
+      if (mFilterParams.mFilters.empty() ||
+          (static_cast<int>(mData.size()) <= mLabelParams.mColumnNameIdx))
+      {
+        pRow.push_back(Unquote(Trim(pCell)));
+        return;
+      }
+
+      if (!pState.mResolved)
+      {
+        ResolveFilters(pState);
+      }
+
+      const size_t cellIdx = pState.mCellCount++;
+      if (pState.mRejected)
+      {
+        return;
+      }
+
+      std::string val = Unquote(Trim(pCell));
+      if (cellIdx < pState.mColumnFilters.size())
+      {
+        for (const RowFilter* filter : pState.mColumnFilters[cellIdx])
+        {
+          if (!filter->Matches(val))
+          {
+            pState.mRejected = true;
+            return;
+          }
+        }
+      }
+      pRow.push_back(std::move(val));
+    }
+
+    bool IsRowAccepted(RowFilterState& pState) const
+    {
+      // rows too short to hold all filtered columns are rejected as well
+      const bool accepted = !pState.mRejected && (pState.mCellCount >= pState.mColumnFilters.size());
+      pState.mRejected = false;
+      pState.mCellCount = 0;
+      return accepted;
+    }
+
+    void ResolveFilters(RowFilterState& pState) const
+    {
+      for (const RowFilter& filter : mFilterParams.mFilters)
+      {
+        size_t dataColumnIdx = 0;
+        if (filter.mColumnIdx >= 0)
+        {
+          dataColumnIdx = GetDataColumnIndex(static_cast<size_t>(filter.mColumnIdx));
+        }
+        else
+        {
+          if (mLabelParams.mColumnNameIdx < 0)
+          {
+            throw std::out_of_range("column name row index < 0: " + std::to_string(mLabelParams.mColumnNameIdx));
+          }
+
+          const std::vector<std::string>& columnNames = mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx));
+          const auto itName = std::find(columnNames.begin() + (mLabelParams.mRowNameIdx + 1), columnNames.end(),
+                                        filter.mColumnName);
+          if (itName == columnNames.end())
+          {
+            throw std::out_of_range("column not found: " + filter.mColumnName);
+          }
+          dataColumnIdx = static_cast<size_t>(std::distance(columnNames.begin(), itName));
+        }
+
+        if (dataColumnIdx >= pState.mColumnFilters.size())
+        {
+          pState.mColumnFilters.resize(dataColumnIdx + 1);
+        }
+        pState.mColumnFilters[dataColumnIdx].push_back(&filter);
+      }
+      pState.mResolved = true;
+    }
+
+    struct GroupState
+    {
+      std::vector<size_t> mFirstRows;
+      std::vector<size_t> mHashes;
+      std::vector<long long> mCounts;
+      std::vector<long double> mValues;
+      std::vector<size_t> mSlots;
+    };
+
+    size_t HashKey(const std::vector<size_t>& pKeyColumns, const size_t pRowIdx) const
+    {
+      size_t hash = 0;
+      for (const size_t columnIdx : pKeyColumns)
+      {
+        const size_t cellHash = std::hash<std::string_view>{ }(mData[pRowIdx].at(columnIdx));
+        hash ^= cellHash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+
+    size_t FindOrAddGroup(GroupState& pState, const std::vector<size_t>& pKeyColumns,
+                          const std::vector<GroupAggregate>& pAggregates,
+                          const size_t pRowIdx, const size_t pHash) const
+    {
+      // keep the load factor of the open-addressing table at most 1/2
+      if ((pState.mFirstRows.size() + 1) * 2 > pState.mSlots.size())
+      {
+        pState.mSlots.assign(std::max<size_t>(16, pState.mSlots.size() * 2), 0);
+        const size_t mask = pState.mSlots.size() - 1;
+        for (size_t groupIdx = 0; groupIdx < pState.mFirstRows.size(); ++groupIdx)
+        {
+          size_t slot = pState.mHashes[groupIdx] & mask;
+          while (pState.mSlots[slot] != 0)
+          {
+            slot = (slot + 1) & mask;
+          }
+          pState.mSlots[slot] = groupIdx + 1;
+        }
+      }
+
+      const size_t mask = pState.mSlots.size() - 1;
+      for (size_t slot = pHash & mask; ; slot = (slot + 1) & mask)
+      {
+        const size_t entry = pState.mSlots[slot];
+        if (entry == 0)
+        {
+          pState.mSlots[slot] = pState.mFirstRows.size() + 1;
+          pState.mFirstRows.push_back(pRowIdx);
+          pState.mHashes.push_back(pHash);
+          pState.mCounts.push_back(0);
+          for (const GroupAggregate& aggregate : pAggregates)
+          {
+            pState.mValues.push_back((aggregate.mType == GroupAggregate::AggregateMin) ?
+                                     std::numeric_limits<long double>::infinity() :
+                                     (aggregate.mType == GroupAggregate::AggregateMax) ?
+                                     -std::numeric_limits<long double>::infinity() : 0);
+          }
+          return pState.mFirstRows.size() - 1;
+        }
+
+        const size_t groupIdx = entry - 1;
+        if (pState.mHashes[groupIdx] == pHash)
+        {
+          const std::vector<std::string>& groupRow = mData[pState.mFirstRows[groupIdx]];
+          const std::vector<std::string>& row = mData[pRowIdx];
+          if (std::all_of(pKeyColumns.begin(), pKeyColumns.end(),
+                          [&](size_t columnIdx) { return groupRow.at(columnIdx) == row.at(columnIdx); }))
+          {
+            return groupIdx;
+          }
+        }
+      }
+    }
+
+    void Accumulate(GroupState& pState, const std::vector<GroupAggregate>& pAggregates,
+                    const std::vector<int>& pAggregateColumns, const size_t pGroupIdx, const size_t pRowIdx) const
     {
-      const size_t rowIdx = GetDataRowIndex(pRowIdx);
+      ++pState.mCounts[pGroupIdx];
 
-      std::vector<std::string> row;
-      if (pRow.empty())
+      Converter<long double> converter(mConverterParams);
+      long double* values = pState.mValues.data() + pGroupIdx * pAggregates.size();
+      for (size_t i = 0; i < pAggregates.size(); ++i)
       {
-        row.resize(GetDataColumnCount());
+        if (pAggregates[i].mType == GroupAggregate::AggregateCount)
+        {
+          values[i] += 1;
+          continue;
+        }
+
+        long double val = 0;
+        converter.ToVal(mData[pRowIdx].at(static_cast<size_t>(pAggregateColumns[i])), val);
+        switch (pAggregates[i].mType)
+        {
+          case GroupAggregate::AggregateSum:
+            values[i] += val;
+            break;
+          case GroupAggregate::AggregateMin:
+            values[i] = std::min(values[i], val);
+            break;
+          default:
+            values[i] = std::max(values[i], val);
+            break;
+        }
+      }
+    }
+
+    static void Combine(GroupState& pState, const std::vector<GroupAggregate>& pAggregates, const size_t pGroupIdx,
+                        const GroupState& pOther, const size_t pOtherGroupIdx)
+    {
+      pState.mCounts[pGroupIdx] += pOther.mCounts[pOtherGroupIdx];
+
+      long double* values = pState.mValues.data() + pGroupIdx * pAggregates.size();
+      const long double* otherValues = pOther.mValues.data() + pOtherGroupIdx * pAggregates.size();
+      for (size_t i = 0; i < pAggregates.size(); ++i)
+      {
+        switch (pAggregates[i].mType)
+        {
+          case GroupAggregate::AggregateMin:
+            values[i] = std::min(values[i], otherValues[i]);
+            break;
+          case GroupAggregate::AggregateMax:
+            values[i] = std::max(values[i], otherValues[i]);
+            break;
+          default:
+            values[i] += otherValues[i];
+            break;
+        }
+      }
+    }
+
+    void WriteCsv() const
+    {
+#ifdef HAS_CODECVT
+      if (mIsUtf16)
+      {
+        std::stringstream ss;
+        WriteCsv(ss);
+        std::string utf8 = ss.str();
+        std::wstring wstr = ToWString(utf8);
+
+        std::wofstream wstream;
+        wstream.exceptions(std::wofstream::failbit | std::wofstream::badbit);
+        wstream.open(mPath, std::ios::binary | std::ios::trunc);
+
+        if (mIsLE)
+        {
+          wstream.imbue(std::locale(wstream.getloc(),
+                                    new std::codecvt_utf16<wchar_t, 0x10ffff,
+                                                           static_cast<std::codecvt_mode>(std::little_endian)>));
+        }
+        else
+        {
+          wstream.imbue(std::locale(wstream.getloc(),
+                                    new std::codecvt_utf16<wchar_t, 0x10ffff>));
+        }
+
+        wstream << static_cast<wchar_t>(0xfeff);
+        wstream << wstr;
       }
       else
+#endif
       {
-        row.resize(GetDataColumnIndex(pRow.size()));
-        Converter<T> converter(mConverterParams);
-        for (auto itCol = pRow.begin(); itCol != pRow.end(); ++itCol)
+        std::ofstream stream;
+        stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        stream.open(mPath, std::ios::binary | std::ios::trunc);
+        if (mHasUtf8BOM)
         {
-          std::string str;
-          converter.ToStr(*itCol, str);
-          row.at(static_cast<size_t>(std::distance(pRow.begin(), itCol) + mLabelParams.mRowNameIdx + 1)) = str;
+          stream.write(s_Utf8BOM.data(), 3);
         }
+
+        WriteCsv(stream);
       }
+    }
 
-      while (rowIdx > GetDataRowCount())
+    void WriteCsv(std::ostream& pStream) const
+    {
+      for (auto itr = mData.begin(); itr != mData.end(); ++itr)
       {
-        std::vector<std::string> tempRow;
-        tempRow.resize(GetDataColumnCount());
-        mData.push_back(tempRow);
+        for (auto itc = itr->begin(); itc != itr->end(); ++itc)
+        {
+          if (mSeparatorParams.mAutoQuote &&
+              ((itc->find(mSeparatorParams.mSeparator) != std::string::npos) ||
+               (itc->find(' ') != std::string::npos) ||
+               (itc->find('\n') != std::string::npos)))
+          {
+            // escape quotes in string
+            std::string str = *itc;
+            const std::string quoteCharStr = std::string(1, mSeparatorParams.mQuoteChar);
+            ReplaceString(str, quoteCharStr, quoteCharStr + quoteCharStr);
+
+            pStream << quoteCharStr << str << quoteCharStr;
+          }
+          else
+          {
+            pStream << *itc;
+          }
+
+          if (std::distance(itc, itr->end()) > 1)
+          {
+            pStream << mSeparatorParams.mSeparator;
+          }
+        }
+        pStream << (mSeparatorParams.mHasCR ? "\r\n" : "\n");
       }
+    }
 
-      mData.insert(mData.begin() + static_cast<int>(rowIdx), row);
+    size_t GetDataRowCount() const
+    {
+      return mData.size();
+    }
 
-      if (!pRowName.empty())
+    size_t GetDataColumnCount() const
+    {
+      const size_t firstDataRow = static_cast<size_t>((mLabelParams.mColumnNameIdx >= 0) ? mLabelParams.mColumnNameIdx : 0);
+      return (mData.size() > firstDataRow) ? mData.at(firstDataRow).size() : 0;
+    }
+
+    inline size_t GetDataRowIndex(const size_t pRowIdx) const
+    {
+      const size_t firstDataRow = static_cast<size_t>((mLabelParams.mColumnNameIdx + 1 >= 0) ? mLabelParams.mColumnNameIdx + 1 : 0);
+      return pRowIdx + firstDataRow;
+    }
+
+    inline size_t GetDataColumnIndex(const size_t pColumnIdx) const
+    {
+      const size_t firstDataColumn = static_cast<size_t>((mLabelParams.mRowNameIdx + 1 >= 0) ? mLabelParams.mRowNameIdx + 1 : 0);
+      return pColumnIdx + firstDataColumn;
+    }
+
+    std::string Trim(const std::string& pStr) const
+    {
+      if (mSeparatorParams.mTrim)
       {
-        SetRowName(pRowIdx, pRowName);
+        std::string str = pStr;
+
+        // ltrim
+        str.erase(str.begin(), std::find_if(str.begin(), str.end(), [](int ch) { return !isspace(ch); }));
+
+        // rtrim
+        str.erase(std::find_if(str.rbegin(), str.rend(), [](int ch) { return !isspace(ch); }).base(), str.end());
+
+        return str;
+      }
+      else
+      {
+        return pStr;
       }
+    }
 
-      UpdateRowNames();
+    std::string Unquote(const std::string& pStr) const
+    {
+      if (mSeparatorParams.mAutoQuote && (pStr.size() >= 2) &&
+          (pStr.front() == mSeparatorParams.mQuoteChar) &&
+          (pStr.back() == mSeparatorParams.mQuoteChar))
+      {
+        // remove start/end quotes
+        std::string str = pStr.substr(1, pStr.size() - 2);
+
+        // unescape quotes in string
+        const std::string quoteCharStr = std::string(1, mSeparatorParams.mQuoteChar);
+        ReplaceString(str, quoteCharStr + quoteCharStr, quoteCharStr);
+
+        return str;
+      }
+      else
+      {
+        return pStr;
+      }
     }
 
-    /**
-     * @brief   Get number of data rows (excluding label rows).
-     * @returns row count.
-     */
-    size_t GetRowCount() const
+    void UpdateColumnNames()
     {
-      const int count = static_cast<int>(mData.size()) - (mLabelParams.mColumnNameIdx + 1);
-      return (count >= 0) ? static_cast<size_t>(count) : 0;
+      mColumnNames.clear();
+      if ((mLabelParams.mColumnNameIdx >= 0) &&
+          (static_cast<int>(mData.size()) > mLabelParams.mColumnNameIdx))
+      {
+        size_t i = 0;
+        for (auto& columnName : mData[static_cast<size_t>(mLabelParams.mColumnNameIdx)])
+        {
+          mColumnNames[columnName] = i++;
+        }
+      }
     }
 
+    void UpdateRowNames()
+    {
+      mRowNames.clear();
+      if ((mLabelParams.mRowNameIdx >= 0) &&
+          (static_cast<int>(mData.size()) >
+           (mLabelParams.mColumnNameIdx + 1)))
+      {
+        size_t i = 0;
+        for (auto& dataRow : mData)
+        {
+          if (static_cast<int>(dataRow.size()) > mLabelParams.mRowNameIdx)
+          {
+            mRowNames[dataRow[static_cast<size_t>(mLabelParams.mRowNameIdx)]] = i++;
+          }
+        }
+      }
+    }
+
+#ifdef HAS_CODECVT
+#if defined(_MSC_VER)
+#pragma warning (push)
+#pragma warning (disable: 4996)
+#endif
+    static std::string ToString(const std::wstring& pWStr)
+    {
+      return std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t>{ }.to_bytes(pWStr);
+    }
+
+    static std::wstring ToWString(const std::string& pStr)
+    {
+      return std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t>{ }.from_bytes(pStr);
+    }
+#if defined(_MSC_VER)
+#pragma warning (pop)
+#endif
+#endif
+
+    static void ReplaceString(std::string& pStr, const std::string& pSearch, const std::string& pReplace)
+    {
+      size_t pos = 0;
+
+      while ((pos = pStr.find(pSearch, pos)) != std::string::npos)
+      {
+        pStr.replace(pos, pSearch.size(), pReplace);
+        pos += pReplace.size();
+      }
+    }
+
+  private:
+    std::string mPath;
+    LabelParams mLabelParams;
+    SeparatorParams mSeparatorParams;
+    ConverterParams mConverterParams;
+    LineReaderParams mLineReaderParams;
+    FilterParams mFilterParams;
+    std::vector<std::vector<std::string>> mData;
+    std::map<std::string, size_t> mColumnNames;
+    std::map<std::string, size_t> mRowNames;
+#ifdef HAS_CODECVT
+    bool mIsUtf16 = false;
+    bool mIsLE = false;
+#endif
+    bool mHasUtf8BOM = false;
+  };
+
+  /**
+   * @brief     Class providing read-only random access to a CSV-file without parsing it up front.
+   *            Loading makes a single quote-aware scan building a line-offset index, and the cells
+   *            of a row are only parsed when the row is accessed. Recently parsed rows are kept in
+   *            an LRU cache. Row lookup by label name is not supported, as it would require a full
+   *            parse of the file.
+   */
+  class LazyDocument
+  {
+  public:
     /**
-     * @brief   Get cell by index.
-     * @param   pColumnIdx            zero-based column index.
-     * @param   pRowIdx               zero-based row index.
-     * @returns cell data.
-     */
-    template<typename T>
-    T GetCell(const size_t pColumnIdx, const size_t pRowIdx) const
+     * @brief   Constructor
+     * @param   pPath                 specifies the path of an existing CSV-file.
+     * @param   pLabelParams          specifies which row and column should be treated as labels.
+     * @param   pSeparatorParams      specifies which field and row separators should be used.
+     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
+     *                                handled.
+     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @param   pLazyParams           specifies the row cache size and line-offset index persistence.
+     */
+    explicit LazyDocument(const std::string& pPath,
+                          const LabelParams& pLabelParams = LabelParams(),
+                          const SeparatorParams& pSeparatorParams = SeparatorParams(),
+                          const ConverterParams& pConverterParams = ConverterParams(),
+                          const LineReaderParams& pLineReaderParams = LineReaderParams(),
+                          const LazyParams& pLazyParams = LazyParams())
+      : mPath(pPath)
+      , mLabelParams(pLabelParams)
+      , mSeparatorParams(pSeparatorParams)
+      , mConverterParams(pConverterParams)
+      , mLineReaderParams(pLineReaderParams)
+      , mLazyParams(pLazyParams)
     {
-      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
-
-      T val;
-      Converter<T> converter(mConverterParams);
-      converter.ToVal(mData.at(dataRowIdx).at(dataColumnIdx), val);
-      return val;
+      ReadIndex();
     }
 
     /**
-     * @brief   Get cell by index.
-     * @param   pColumnIdx            zero-based column index.
-     * @param   pRowIdx               zero-based row index.
-     * @param   pToVal                conversion function.
-     * @returns cell data.
+     * @brief   Index a CSV-file for lazy access.
+     * @param   pPath                 specifies the path of an existing CSV-file.
+     * @param   pLabelParams          specifies which row and column should be treated as labels.
+     * @param   pSeparatorParams      specifies which field and row separators should be used.
+     * @param   pConverterParams      specifies how invalid numbers (including empty strings) should be
+     *                                handled.
+     * @param   pLineReaderParams     specifies how special line formats should be treated.
+     * @param   pLazyParams           specifies the row cache size and line-offset index persistence.
      */
-    template<typename T>
-    T GetCell(const size_t pColumnIdx, const size_t pRowIdx, ConvFunc<T> pToVal) const
+    void Load(const std::string& pPath,
+              const LabelParams& pLabelParams = LabelParams(),
+              const SeparatorParams& pSeparatorParams = SeparatorParams(),
+              const ConverterParams& pConverterParams = ConverterParams(),
+              const LineReaderParams& pLineReaderParams = LineReaderParams(),
+              const LazyParams& pLazyParams = LazyParams())
     {
-      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
-
-      T val;
-      pToVal(mData.at(dataRowIdx).at(dataColumnIdx), val);
-      return val;
+      mPath = pPath;
+      mLabelParams = pLabelParams;
+      mSeparatorParams = pSeparatorParams;
+      mConverterParams = pConverterParams;
+      mLineReaderParams = pLineReaderParams;
+      mLazyParams = pLazyParams;
+      ReadIndex();
     }
 
     /**
-     * @brief   Get cell by name.
+     * @brief   Get column index by name.
      * @param   pColumnName           column label name.
-     * @param   pRowName              row label name.
-     * @returns cell data.
+     * @returns zero-based column index.
      */
-    template<typename T>
-    T GetCell(const std::string& pColumnName, const std::string& pRowName) const
+    int GetColumnIdx(const std::string& pColumnName) const
     {
-      const int columnIdx = GetColumnIdx(pColumnName);
-      if (columnIdx < 0)
-      {
-        throw std::out_of_range("column not found: " + pColumnName);
-      }
-
-      const int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
+      if (mLabelParams.mColumnNameIdx >= 0)
       {
-        throw std::out_of_range("row not found: " + pRowName);
+        if (mColumnNames.find(pColumnName) != mColumnNames.end())
+        {
+          return static_cast<int>(mColumnNames.at(pColumnName)) - (mLabelParams.mRowNameIdx + 1);
+        }
       }
-
-      return GetCell<T>(static_cast<size_t>(columnIdx), static_cast<size_t>(rowIdx));
+      return -1;
     }
 
     /**
-     * @brief   Get cell by name.
-     * @param   pColumnName           column label name.
-     * @param   pRowName              row label name.
-     * @param   pToVal                conversion function.
-     * @returns cell data.
+     * @brief   Get number of data columns (excluding label columns).
+     * @returns column count.
      */
-    template<typename T>
-    T GetCell(const std::string& pColumnName, const std::string& pRowName, ConvFunc<T> pToVal) const
+    size_t GetColumnCount() const
     {
-      const int columnIdx = GetColumnIdx(pColumnName);
-      if (columnIdx < 0)
-      {
-        throw std::out_of_range("column not found: " + pColumnName);
-      }
-
-      const int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
-      {
-        throw std::out_of_range("row not found: " + pRowName);
-      }
-
-      return GetCell<T>(static_cast<size_t>(columnIdx), static_cast<size_t>(rowIdx), pToVal);
+      const int count = static_cast<int>(mFirstRowSize) - (mLabelParams.mRowNameIdx + 1);
+      return (count >= 0) ? static_cast<size_t>(count) : 0;
     }
 
     /**
-     * @brief   Get cell by column name and row index.
-     * @param   pColumnName           column label name.
-     * @param   pRowIdx               zero-based row index.
-     * @returns cell data.
+     * @brief   Get number of data rows (excluding label rows).
+     * @returns row count.
      */
-    template<typename T>
-    T GetCell(const std::string& pColumnName, const size_t pRowIdx) const
+    size_t GetRowCount() const
     {
-      const int columnIdx = GetColumnIdx(pColumnName);
-      if (columnIdx < 0)
-      {
-        throw std::out_of_range("column not found: " + pColumnName);
-      }
-
-      return GetCell<T>(static_cast<size_t>(columnIdx), pRowIdx);
+      const int64_t count = static_cast<int64_t>(mRowOffsets.size()) - (mLabelParams.mColumnNameIdx + 1);
+      return (count >= 0) ? static_cast<size_t>(count) : 0;
     }
 
     /**
-     * @brief   Get cell by column name and row index.
-     * @param   pColumnName           column label name.
+     * @brief   Get row by index.
      * @param   pRowIdx               zero-based row index.
-     * @param   pToVal                conversion function.
-     * @returns cell data.
+     * @returns vector of row data.
      */
     template<typename T>
-    T GetCell(const std::string& pColumnName, const size_t pRowIdx, ConvFunc<T> pToVal) const
+    std::vector<T> GetRow(const size_t pRowIdx) const
     {
-      const int columnIdx = GetColumnIdx(pColumnName);
-      if (columnIdx < 0)
+      const std::vector<std::string>& dataRow = GetDataRow(GetDataRowIndex(pRowIdx));
+      std::vector<T> row;
+      Converter<T> converter(mConverterParams);
+      for (auto itCol = dataRow.begin(); itCol != dataRow.end(); ++itCol)
       {
-        throw std::out_of_range("column not found: " + pColumnName);
+        if (std::distance(dataRow.begin(), itCol) > mLabelParams.mRowNameIdx)
+        {
+          T val;
+          converter.ToVal(*itCol, val);
+          row.push_back(val);
+        }
       }
-
-      return GetCell<T>(static_cast<size_t>(columnIdx), pRowIdx, pToVal);
+      return row;
     }
 
     /**
-     * @brief   Get cell by column index and row name.
-     * @param   pColumnIdx            zero-based column index.
-     * @param   pRowName              row label name.
-     * @returns cell data.
+     * @brief   Get row by index.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pToVal                conversion function.
+     * @returns vector of row data.
      */
     template<typename T>
-    T GetCell(const size_t pColumnIdx, const std::string& pRowName) const
+    std::vector<T> GetRow(const size_t pRowIdx, ConvFunc<T> pToVal) const
     {
-      const int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
+      const std::vector<std::string>& dataRow = GetDataRow(GetDataRowIndex(pRowIdx));
+      std::vector<T> row;
+      for (auto itCol = dataRow.begin(); itCol != dataRow.end(); ++itCol)
       {
-        throw std::out_of_range("row not found: " + pRowName);
+        if (std::distance(dataRow.begin(), itCol) > mLabelParams.mRowNameIdx)
+        {
+          T val;
+          pToVal(*itCol, val);
+          row.push_back(val);
+        }
       }
-
-      return GetCell<T>(pColumnIdx, static_cast<size_t>(rowIdx));
+      return row;
     }
 
     /**
-     * @brief   Get cell by column index and row name.
+     * @brief   Get cell by index.
      * @param   pColumnIdx            zero-based column index.
-     * @param   pRowName              row label name.
-     * @param   pToVal                conversion function.
+     * @param   pRowIdx               zero-based row index.
      * @returns cell data.
      */
     template<typename T>
-    T GetCell(const size_t pColumnIdx, const std::string& pRowName, ConvFunc<T> pToVal) const
+    T GetCell(const size_t pColumnIdx, const size_t pRowIdx) const
     {
-      const int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
-      {
-        throw std::out_of_range("row not found: " + pRowName);
-      }
+      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
+      const std::vector<std::string>& dataRow = GetDataRow(GetDataRowIndex(pRowIdx));
 
-      return GetCell<T>(pColumnIdx, static_cast<size_t>(rowIdx), pToVal);
+      T val;
+      Converter<T> converter(mConverterParams);
+      converter.ToVal(dataRow.at(dataColumnIdx), val);
+      return val;
     }
 
     /**
-     * @brief   Set cell by index.
-     * @param   pRowIdx               zero-based row index.
+     * @brief   Get cell by index.
      * @param   pColumnIdx            zero-based column index.
-     * @param   pCell                 cell data.
+     * @param   pRowIdx               zero-based row index.
+     * @param   pToVal                conversion function.
+     * @returns cell data.
      */
     template<typename T>
-    void SetCell(const size_t pColumnIdx, const size_t pRowIdx, const T& pCell)
+    T GetCell(const size_t pColumnIdx, const size_t pRowIdx, ConvFunc<T> pToVal) const
     {
       const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
+      const std::vector<std::string>& dataRow = GetDataRow(GetDataRowIndex(pRowIdx));
 
-      while ((dataRowIdx + 1) > GetDataRowCount())
-      {
-        std::vector<std::string> row;
-        row.resize(GetDataColumnCount());
-        mData.push_back(row);
-      }
-
-      if ((dataColumnIdx + 1) > GetDataColumnCount())
-      {
-        for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
-        {
-          if (std::distance(mData.begin(), itRow) >= mLabelParams.mColumnNameIdx)
-          {
-            itRow->resize(dataColumnIdx + 1);
-          }
-        }
-      }
-
-      std::string str;
-      Converter<T> converter(mConverterParams);
-      converter.ToStr(pCell, str);
-      mData.at(dataRowIdx).at(dataColumnIdx) = str;
+      T val;
+      pToVal(dataRow.at(dataColumnIdx), val);
+      return val;
     }
 
     /**
-     * @brief   Set cell by name.
+     * @brief   Get cell by column name and row index.
      * @param   pColumnName           column label name.
-     * @param   pRowName              row label name.
-     * @param   pCell                 cell data.
+     * @param   pRowIdx               zero-based row index.
+     * @returns cell data.
      */
     template<typename T>
-    void SetCell(const std::string& pColumnName, const std::string& pRowName, const T& pCell)
+    T GetCell(const std::string& pColumnName, const size_t pRowIdx) const
     {
       const int columnIdx = GetColumnIdx(pColumnName);
       if (columnIdx < 0)
@@ -1307,41 +3270,18 @@ namespace rapidcsv
         throw std::out_of_range("column not found: " + pColumnName);
       }
 
-      const int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
-      {
-        throw std::out_of_range("row not found: " + pRowName);
-      }
-
-      SetCell<T>(static_cast<size_t>(columnIdx), static_cast<size_t>(rowIdx), pCell);
-    }
-
-    /**
-     * @brief   Set cell by column index and row name.
-     * @param   pColumnIdx            zero-based column index.
-     * @param   pRowName              row label name.
-     * @param   pCell                 cell data.
-     */
-    template<typename T>
-    void SetCell(const size_t pColumnIdx, const std::string& pRowName, const T& pCell)
-    {
-      const int rowIdx = GetRowIdx(pRowName);
-      if (rowIdx < 0)
-      {
-        throw std::out_of_range("row not found: " + pRowName);
-      }
-
-      SetCell<T>(pColumnIdx, static_cast<size_t>(rowIdx), pCell);
+      return GetCell<T>(static_cast<size_t>(columnIdx), pRowIdx);
     }
 
     /**
-     * @brief   Set cell by column name and row index.
+     * @brief   Get cell by column name and row index.
      * @param   pColumnName           column label name.
      * @param   pRowIdx               zero-based row index.
-     * @param   pCell                 cell data.
+     * @param   pToVal                conversion function.
+     * @returns cell data.
      */
     template<typename T>
-    void SetCell(const std::string& pColumnName, const size_t pRowIdx, const T& pCell)
+    T GetCell(const std::string& pColumnName, const size_t pRowIdx, ConvFunc<T> pToVal) const
     {
       const int columnIdx = GetColumnIdx(pColumnName);
       if (columnIdx < 0)
@@ -1349,7 +3289,7 @@ namespace rapidcsv
         throw std::out_of_range("column not found: " + pColumnName);
       }
 
-      SetCell<T>(static_cast<size_t>(columnIdx), pRowIdx, pCell);
+      return GetCell<T>(static_cast<size_t>(columnIdx), pRowIdx, pToVal);
     }
 
     /**
@@ -1365,37 +3305,7 @@ namespace rapidcsv
         throw std::out_of_range("column name row index < 0: " + std::to_string(mLabelParams.mColumnNameIdx));
       }
 
-      return mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).at(dataColumnIdx);
-    }
-
-    /**
-     * @brief   Set column name
-     * @param   pColumnIdx            zero-based column index.
-     * @param   pColumnName           column name.
-     */
-    void SetColumnName(size_t pColumnIdx, const std::string& pColumnName)
-    {
-      if (mLabelParams.mColumnNameIdx < 0)
-      {
-        throw std::out_of_range("column name row index < 0: " + std::to_string(mLabelParams.mColumnNameIdx));
-      }
-
-      const size_t dataColumnIdx = GetDataColumnIndex(pColumnIdx);
-      mColumnNames[pColumnName] = dataColumnIdx;
-
-      // increase table size if necessary:
-      const size_t rowIdx = static_cast<size_t>(mLabelParams.mColumnNameIdx);
-      if (rowIdx >= mData.size())
-      {
-        mData.resize(rowIdx + 1);
-      }
-      auto& row = mData[rowIdx];
-      if (dataColumnIdx >= row.size())
-      {
-        row.resize(dataColumnIdx + 1);
-      }
-
-      mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).at(dataColumnIdx) = pColumnName;
+      return mColumnNameRow.at(dataColumnIdx);
     }
 
     /**
@@ -1404,11 +3314,11 @@ namespace rapidcsv
      */
     std::vector<std::string> GetColumnNames() const
     {
-      if (mLabelParams.mColumnNameIdx >= 0)
+      if ((mLabelParams.mColumnNameIdx >= 0) &&
+          (mColumnNameRow.size() > static_cast<size_t>(mLabelParams.mRowNameIdx + 1)))
       {
-        return std::vector<std::string>(mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).begin() +
-                                        (mLabelParams.mRowNameIdx + 1),
-                                        mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).end());
+        return std::vector<std::string>(mColumnNameRow.begin() + (mLabelParams.mRowNameIdx + 1),
+                                        mColumnNameRow.end());
       }
 
       return std::vector<std::string>();
@@ -1416,372 +3326,456 @@ namespace rapidcsv
 
     /**
      * @brief   Get row name
-     * @param   pRowIdx               zero-based column index.
+     * @param   pRowIdx               zero-based row index.
      * @returns row name.
      */
     std::string GetRowName(const size_t pRowIdx) const
     {
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
       if (mLabelParams.mRowNameIdx < 0)
       {
         throw std::out_of_range("row name column index < 0: " + std::to_string(mLabelParams.mRowNameIdx));
       }
 
-      return mData.at(dataRowIdx).at(static_cast<size_t>(mLabelParams.mRowNameIdx));
+      return GetDataRow(GetDataRowIndex(pRowIdx)).at(static_cast<size_t>(mLabelParams.mRowNameIdx));
     }
 
-    /**
-     * @brief   Set row name
-     * @param   pRowIdx               zero-based row index.
-     * @param   pRowName              row name.
-     */
-    void SetRowName(size_t pRowIdx, const std::string& pRowName)
+  private:
+    void ReadIndex()
     {
-      const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
-      mRowNames[pRowName] = dataRowIdx;
-      if (mLabelParams.mRowNameIdx < 0)
-      {
-        throw std::out_of_range("row name column index < 0: " + std::to_string(mLabelParams.mRowNameIdx));
+      mBlockOffsets.clear();
+      mRowOffsets.clear();
+      mColumnNameRow.clear();
+      mColumnNames.clear();
+      mFirstRowSize = 0;
+      mCache.clear();
+      mLru.clear();
+
+      mStream.exceptions(std::ifstream::goodbit);
+      mStream.close();
+      mStream.clear();
+      mStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+      mStream.open(mPath, std::ios::binary);
+      mStream.seekg(0, std::ios::end);
+      mFileLength = static_cast<uint64_t>(mStream.tellg());
+      mStream.seekg(0, std::ios::beg);
+
+      // check for UTF-8 Byte order mark and skip it when found
+      mDataOffset = 0;
+      if (mFileLength >= 3)
+      {
+        std::vector<char> bom3b(3, '\0');
+        mStream.read(bom3b.data(), 3);
+        if (bom3b == s_Utf8BOM)
+        {
+          mDataOffset = 3;
+        }
       }
 
-      // increase table size if necessary:
-      if (dataRowIdx >= mData.size())
+      if (!ReadIndexFile())
       {
-        mData.resize(dataRowIdx + 1);
+        ScanCsv();
+        WriteIndexFile();
       }
-      auto& row = mData[dataRowIdx];
-      if (mLabelParams.mRowNameIdx >= static_cast<int>(row.size()))
+
+      if (!mRowOffsets.empty())
       {
-        row.resize(static_cast<size_t>(mLabelParams.mRowNameIdx) + 1);
+        std::vector<std::string> row;
+        ReadRow(0, row);
+        mFirstRowSize = row.size();
       }
 
-      mData.at(dataRowIdx).at(static_cast<size_t>(mLabelParams.mRowNameIdx)) = pRowName;
-    }
-
-    /**
-     * @brief   Get row names
-     * @returns vector of row names.
-     */
-    std::vector<std::string> GetRowNames() const
-    {
-      std::vector<std::string> rownames;
-      if (mLabelParams.mRowNameIdx >= 0)
+      // Set up column labels
+      if ((mLabelParams.mColumnNameIdx >= 0) &&
+          (mRowOffsets.size() > static_cast<size_t>(mLabelParams.mColumnNameIdx)))
       {
-        for (auto itRow = mData.begin(); itRow != mData.end(); ++itRow)
+        ReadRow(static_cast<size_t>(mLabelParams.mColumnNameIdx), mColumnNameRow);
+        size_t i = 0;
+        for (auto& columnName : mColumnNameRow)
         {
-          if (std::distance(mData.begin(), itRow) > mLabelParams.mColumnNameIdx)
-          {
-            rownames.push_back(itRow->at(static_cast<size_t>(mLabelParams.mRowNameIdx)));
-          }
+          mColumnNames[columnName] = i++;
         }
       }
-      return rownames;
     }
 
-  private:
-    void ReadCsv()
+    struct ScanState
     {
-      std::ifstream stream;
-      stream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-      stream.open(mPath, std::ios::binary);
-      ReadCsv(stream);
-    }
+      bool mQuoted = false;
+      bool mRowEmpty = true;
+      bool mCellEmpty = true;
+      bool mCellQuoted = false;
+      bool mLeadingSpace = true;
+      bool mHasQuote = false;
+      bool mInFirstCell = true;
+      std::string mFirstCell;
+    };
 
-    void ReadCsv(std::istream& pStream)
+    void ScanCsv()
     {
-      Clear();
-      pStream.seekg(0, std::ios::end);
-      std::streamsize length = pStream.tellg();
-      pStream.seekg(0, std::ios::beg);
-
-#ifdef HAS_CODECVT
-      std::vector<char> bom2b(2, '\0');
-      if (length >= 2)
-      {
-        pStream.read(bom2b.data(), 2);
-        pStream.seekg(0, std::ios::beg);
-      }
+      // The scan follows the same quoting rules as Document::ParseCsv, but only tracks the state
+      // needed to find row boundaries. Without quoted line breaks and line skipping every LF ends
+      // a row, so rows are found with memchr alone.
+      const bool trackCells = mSeparatorParams.mQuotedLinebreaks ||
+        mLineReaderParams.mSkipEmptyLines || mLineReaderParams.mSkipCommentLines;
+      const std::streamsize bufLength = 1024 * 1024;
+      std::vector<char> buffer(bufLength);
+      ScanState state;
+      uint64_t bufferOffset = mDataOffset;
+      uint64_t lineOffset = mDataOffset;
+      bool lineHasData = false;
 
-      static const std::vector<char> bomU16le = { '\xff', '\xfe' };
-      static const std::vector<char> bomU16be = { '\xfe', '\xff' };
-      if ((bom2b == bomU16le) || (bom2b == bomU16be))
+      mStream.seekg(static_cast<std::streamoff>(mDataOffset), std::ios::beg);
+      while (bufferOffset < mFileLength)
       {
-        mIsUtf16 = true;
-        mIsLE = (bom2b == bomU16le);
+        const std::streamsize readLength =
+          static_cast<std::streamsize>(std::min<uint64_t>(mFileLength - bufferOffset, bufLength));
+        mStream.read(buffer.data(), readLength);
 
-        std::wifstream wstream;
-        wstream.exceptions(std::wifstream::failbit | std::wifstream::badbit);
-        wstream.open(mPath, std::ios::binary);
-        if (mIsLE)
-        {
-          wstream.imbue(std::locale(wstream.getloc(),
-                                    new std::codecvt_utf16<wchar_t, 0x10ffff,
-                                                           static_cast<std::codecvt_mode>(std::consume_header |
-                                                                                          std::little_endian)>));
-        }
-        else
-        {
-          wstream.imbue(std::locale(wstream.getloc(),
-                                    new std::codecvt_utf16<wchar_t, 0x10ffff,
-                                                           std::consume_header>));
-        }
-        std::wstringstream wss;
-        wss << wstream.rdbuf();
-        std::string utf8 = ToString(wss.str());
-        std::stringstream ss(utf8);
-        ParseCsv(ss, static_cast<std::streamsize>(utf8.size()));
-      }
-      else
-#endif
-      {
-        // check for UTF-8 Byte order mark and skip it when found
-        if (length >= 3)
+        if (!trackCells)
         {
-          std::vector<char> bom3b(3, '\0');
-          pStream.read(bom3b.data(), 3);
-
-          if (bom3b != s_Utf8BOM)
+          const char* begin = buffer.data();
+          const char* end = begin + readLength;
+          const char* pos = begin;
+          while (const char* lf = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos))))
           {
-            // file does not start with a UTF-8 Byte order mark
-            pStream.seekg(0, std::ios::beg);
-          }
-          else
-          {
-            // file did start with a UTF-8 Byte order mark, simply skip it
-            length -= 3;
-            mHasUtf8BOM = true;
+            AddRow(lineOffset);
+            lineOffset = bufferOffset + static_cast<uint64_t>(lf - begin) + 1;
+            pos = lf + 1;
           }
+          lineHasData = std::any_of(pos, end, [](char ch) { return ch != '\r'; }) ||
+            (lineHasData && (pos == begin));
         }
-
-        ParseCsv(pStream, length);
-      }
-    }
-
-    void ParseCsv(std::istream& pStream, std::streamsize p_FileLength)
-    {
-      const std::streamsize bufLength = 64 * 1024;
-      std::vector<char> buffer(bufLength);
-      std::vector<std::string> row;
-      std::string cell;
-      bool quoted = false;
-      int cr = 0;
-      int lf = 0;
-
-      while (p_FileLength > 0)
-      {
-        const std::streamsize toReadLength = std::min<std::streamsize>(p_FileLength, bufLength);
-        pStream.read(buffer.data(), toReadLength);
-
-        // With user-specified istream opened in non-binary mode on windows, we may have a
-        // data length mismatch, so ensure we don't parse outside actual data length read.
-        const std::streamsize readLength = pStream.gcount();
-        if (readLength <= 0)
-        {
-          break;
-        }
-
-        for (size_t i = 0; i < static_cast<size_t>(readLength); ++i)
+        else
         {
-          if (buffer[i] == mSeparatorParams.mQuoteChar)
-          {
-            if (cell.empty() || (cell[0] == mSeparatorParams.mQuoteChar))
-            {
-              quoted = !quoted;
-            }
-            else if (mSeparatorParams.mTrim)
-            {
-              // allow whitespace before first mQuoteChar
-              const auto firstQuote = std::find(cell.begin(), cell.end(), mSeparatorParams.mQuoteChar);
-              if (std::all_of(cell.begin(), firstQuote, [](int ch) { return isspace(ch); }))
-              {
-                quoted = !quoted;
-              }
-            }
-            cell += buffer[i];
-          }
-          else if (buffer[i] == mSeparatorParams.mSeparator)
-          {
-            if (!quoted)
-            {
-              row.push_back(Unquote(Trim(cell)));
-              cell.clear();
-            }
-            else
-            {
-              cell += buffer[i];
-            }
-          }
-          else if (buffer[i] == '\r')
-          {
-            if (mSeparatorParams.mQuotedLinebreaks && quoted)
-            {
-              cell += buffer[i];
-            }
-            else
-            {
-              ++cr;
-            }
-          }
-          else if (buffer[i] == '\n')
+          for (size_t i = 0; i < static_cast<size_t>(readLength); ++i)
           {
-            if (mSeparatorParams.mQuotedLinebreaks && quoted)
-            {
-              cell += buffer[i];
-            }
-            else
+            if (ScanChar(buffer[i], state))
             {
-              ++lf;
-              if (mLineReaderParams.mSkipEmptyLines && row.empty() && cell.empty())
-              {
-                // skip empty line
-              }
-              else
-              {
-                row.push_back(Unquote(Trim(cell)));
-
-                if (mLineReaderParams.mSkipCommentLines && !row.at(0).empty() &&
-                    (row.at(0)[0] == mLineReaderParams.mCommentPrefix))
-                {
-                  // skip comment line
-                }
-                else
-                {
-                  mData.push_back(row);
-                }
-
-                cell.clear();
-                row.clear();
-                quoted = false;
-              }
+              EndScannedLine(state, lineOffset);
+              lineOffset = bufferOffset + i + 1;
             }
           }
-          else
-          {
-            cell += buffer[i];
-          }
         }
-        p_FileLength -= readLength;
+        bufferOffset += static_cast<uint64_t>(readLength);
+      }
+
+      // Handle last row / cell without linebreak
+      if (trackCells)
+      {
+        lineHasData = !(state.mRowEmpty && state.mCellEmpty);
+      }
+
+      if (lineHasData &&
+          !(mLineReaderParams.mSkipCommentLines && IsComment(state.mFirstCell)))
+      {
+        AddRow(lineOffset);
       }
+    }
 
-      // Handle last row / cell without linebreak
-      if (row.empty() && cell.empty())
+    bool ScanChar(const char pCh, ScanState& pState) const
+    {
+      if (pCh == mSeparatorParams.mQuoteChar)
       {
-        // skip empty trailing line
+        if (pState.mCellEmpty || pState.mCellQuoted ||
+            (mSeparatorParams.mTrim && pState.mLeadingSpace))
+        {
+          pState.mQuoted = !pState.mQuoted;
+        }
+        ScanCellChar(pCh, pState);
+      }
+      else if (pCh == mSeparatorParams.mSeparator)
+      {
+        if (!pState.mQuoted)
+        {
+          pState.mRowEmpty = false;
+          pState.mCellEmpty = true;
+          pState.mCellQuoted = false;
+          pState.mLeadingSpace = true;
+          pState.mHasQuote = false;
+          pState.mInFirstCell = false;
+        }
+        else
+        {
+          ScanCellChar(pCh, pState);
+        }
+      }
+      else if ((pCh == '\r') || (pCh == '\n'))
+      {
+        if (mSeparatorParams.mQuotedLinebreaks && pState.mQuoted)
+        {
+          ScanCellChar(pCh, pState);
+        }
+        else if (pCh == '\n')
+        {
+          return true;
+        }
       }
       else
       {
-        row.push_back(Unquote(Trim(cell)));
+        ScanCellChar(pCh, pState);
+      }
+      return false;
+    }
+
+    void ScanCellChar(const char pCh, ScanState& pState) const
+    {
+      if (pState.mCellEmpty)
+      {
+        pState.mCellEmpty = false;
+        pState.mCellQuoted = (pCh == mSeparatorParams.mQuoteChar);
+      }
 
-        if (mLineReaderParams.mSkipCommentLines && !row.at(0).empty() &&
-            (row.at(0)[0] == mLineReaderParams.mCommentPrefix))
+      if (!pState.mHasQuote)
+      {
+        if (pCh == mSeparatorParams.mQuoteChar)
         {
-          // skip comment line
+          pState.mHasQuote = true;
         }
-        else
+        else if (!isspace(static_cast<unsigned char>(pCh)))
         {
-          mData.push_back(row);
+          pState.mLeadingSpace = false;
         }
+      }
 
-        cell.clear();
-        row.clear();
-        quoted = false;
+      if (pState.mInFirstCell && mLineReaderParams.mSkipCommentLines)
+      {
+        pState.mFirstCell += pCh;
       }
+    }
 
-      // Assume CR/LF if at least half the linebreaks have CR
-      mSeparatorParams.mHasCR = (cr > (lf / 2));
+    void EndScannedLine(ScanState& pState, const uint64_t pLineOffset)
+    {
+      if (mLineReaderParams.mSkipEmptyLines && pState.mRowEmpty && pState.mCellEmpty)
+      {
+        // skip empty line
+      }
+      else if (mLineReaderParams.mSkipCommentLines && IsComment(pState.mFirstCell))
+      {
+        // skip comment line
+      }
+      else
+      {
+        AddRow(pLineOffset);
+      }
 
-      // Set up column labels
-      UpdateColumnNames();
+      pState = ScanState();
+    }
 
-      // Set up row labels
-      UpdateRowNames();
+    bool IsComment(const std::string& pFirstCell) const
+    {
+      const std::string cell = Unquote(Trim(pFirstCell));
+      return !cell.empty() && (cell[0] == mLineReaderParams.mCommentPrefix);
     }
 
-    void WriteCsv() const
+    void AddRow(const uint64_t pOffset)
     {
-#ifdef HAS_CODECVT
-      if (mIsUtf16)
+      if ((mRowOffsets.size() % sIndexBlockRows) == 0)
       {
-        std::stringstream ss;
-        WriteCsv(ss);
-        std::string utf8 = ss.str();
-        std::wstring wstr = ToWString(utf8);
+        mBlockOffsets.push_back(pOffset);
+      }
 
-        std::wofstream wstream;
-        wstream.exceptions(std::wofstream::failbit | std::wofstream::badbit);
-        wstream.open(mPath, std::ios::binary | std::ios::trunc);
+      const uint64_t delta = pOffset - mBlockOffsets.back();
+      if (delta > std::numeric_limits<uint32_t>::max())
+      {
+        throw std::length_error("row index block exceeds 4 GiB at row index " +
+                                std::to_string(mRowOffsets.size()));
+      }
+      mRowOffsets.push_back(static_cast<uint32_t>(delta));
+    }
 
-        if (mIsLE)
-        {
-          wstream.imbue(std::locale(wstream.getloc(),
-                                    new std::codecvt_utf16<wchar_t, 0x10ffff,
-                                                           static_cast<std::codecvt_mode>(std::little_endian)>));
-        }
-        else
-        {
-          wstream.imbue(std::locale(wstream.getloc(),
-                                    new std::codecvt_utf16<wchar_t, 0x10ffff>));
-        }
+    uint64_t GetRowOffset(const size_t pRowIdx) const
+    {
+      return mBlockOffsets[pRowIdx / sIndexBlockRows] + mRowOffsets[pRowIdx];
+    }
 
-        wstream << static_cast<wchar_t>(0xfeff);
-        wstream << wstr;
+    uint64_t GetIndexSignature() const
+    {
+      return static_cast<uint64_t>(static_cast<unsigned char>(mSeparatorParams.mSeparator)) |
+             (static_cast<uint64_t>(static_cast<unsigned char>(mSeparatorParams.mQuoteChar)) << 8) |
+             (static_cast<uint64_t>(static_cast<unsigned char>(mLineReaderParams.mCommentPrefix)) << 16) |
+             (static_cast<uint64_t>(mSeparatorParams.mQuotedLinebreaks) << 24) |
+             (static_cast<uint64_t>(mSeparatorParams.mTrim) << 25) |
+             (static_cast<uint64_t>(mSeparatorParams.mAutoQuote) << 26) |
+             (static_cast<uint64_t>(mLineReaderParams.mSkipEmptyLines) << 27) |
+             (static_cast<uint64_t>(mLineReaderParams.mSkipCommentLines) << 28) |
+             (static_cast<uint64_t>(sIndexBlockRows) << 32);
+    }
+
+    int64_t GetFileTime() const
+    {
+      return static_cast<int64_t>(std::filesystem::last_write_time(mPath).time_since_epoch().count());
+    }
+
+    bool ReadIndexFile()
+    {
+      if (mLazyParams.mIndexPath.empty())
+      {
+        return false;
       }
-      else
-#endif
+
+      std::ifstream stream(mLazyParams.mIndexPath, std::ios::binary);
+      if (!stream)
       {
-        std::ofstream stream;
-        stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
-        stream.open(mPath, std::ios::binary | std::ios::trunc);
-        if (mHasUtf8BOM)
-        {
-          stream.write(s_Utf8BOM.data(), 3);
-        }
+        return false;
+      }
 
-        WriteCsv(stream);
+      char magic[sizeof(sIndexMagic)] = { };
+      uint64_t fileLength = 0;
+      int64_t fileTime = 0;
+      uint64_t signature = 0;
+      uint64_t rowCount = 0;
+      stream.read(magic, sizeof(magic));
+      stream.read(reinterpret_cast<char*>(&fileLength), sizeof(fileLength));
+      stream.read(reinterpret_cast<char*>(&fileTime), sizeof(fileTime));
+      stream.read(reinterpret_cast<char*>(&signature), sizeof(signature));
+      stream.read(reinterpret_cast<char*>(&rowCount), sizeof(rowCount));
+      if (!stream || (std::memcmp(magic, sIndexMagic, sizeof(magic)) != 0) ||
+          (fileLength != mFileLength) || (fileTime != GetFileTime()) ||
+          (signature != GetIndexSignature()))
+      {
+        return false;
+      }
+
+      // every row starts at a different byte of the file, so a larger count can only come from a damaged index
+      if (rowCount > mFileLength + 1)
+      {
+        return false;
+      }
+
+      mBlockOffsets.resize(static_cast<size_t>((rowCount + sIndexBlockRows - 1) / sIndexBlockRows));
+      mRowOffsets.resize(static_cast<size_t>(rowCount));
+      stream.read(reinterpret_cast<char*>(mBlockOffsets.data()),
+                  static_cast<std::streamsize>(mBlockOffsets.size() * sizeof(uint64_t)));
+      stream.read(reinterpret_cast<char*>(mRowOffsets.data()),
+                  static_cast<std::streamsize>(mRowOffsets.size() * sizeof(uint32_t)));
+      if (!stream ||
+          !std::all_of(mBlockOffsets.begin(), mBlockOffsets.end(),
+                       [&](const uint64_t offset) { return offset < mFileLength; }))
+      {
+        mBlockOffsets.clear();
+        mRowOffsets.clear();
+        return false;
       }
+      return true;
     }
 
-    void WriteCsv(std::ostream& pStream) const
+    void WriteIndexFile() const
     {
-      for (auto itr = mData.begin(); itr != mData.end(); ++itr)
+      if (mLazyParams.mIndexPath.empty())
       {
-        for (auto itc = itr->begin(); itc != itr->end(); ++itc)
+        return;
+      }
+
+      const uint64_t fileLength = mFileLength;
+      const int64_t fileTime = GetFileTime();
+      const uint64_t signature = GetIndexSignature();
+      const uint64_t rowCount = mRowOffsets.size();
+
+      std::ofstream stream;
+      stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+      stream.open(mLazyParams.mIndexPath, std::ios::binary | std::ios::trunc);
+      stream.write(sIndexMagic, sizeof(sIndexMagic));
+      stream.write(reinterpret_cast<const char*>(&fileLength), sizeof(fileLength));
+      stream.write(reinterpret_cast<const char*>(&fileTime), sizeof(fileTime));
+      stream.write(reinterpret_cast<const char*>(&signature), sizeof(signature));
+      stream.write(reinterpret_cast<const char*>(&rowCount), sizeof(rowCount));
+      stream.write(reinterpret_cast<const char*>(mBlockOffsets.data()),
+                   static_cast<std::streamsize>(mBlockOffsets.size() * sizeof(uint64_t)));
+      stream.write(reinterpret_cast<const char*>(mRowOffsets.data()),
+                   static_cast<std::streamsize>(mRowOffsets.size() * sizeof(uint32_t)));
+    }
+
+    const std::vector<std::string>& GetDataRow(const size_t pDataRowIdx) const
+    {
+      auto itCache = mCache.find(pDataRowIdx);
+      if (itCache != mCache.end())
+      {
+        mLru.splice(mLru.begin(), mLru, itCache->second.second);
+        return itCache->second.first;
+      }
+
+      std::vector<std::string> row;
+      ReadRow(pDataRowIdx, row);
+
+      if (mCache.size() >= mLazyParams.mCacheRows)
+      {
+        mCache.erase(mLru.back());
+        mLru.pop_back();
+      }
+
+      mLru.push_front(pDataRowIdx);
+      auto& entry = mCache[pDataRowIdx];
+      entry.first = std::move(row);
+      entry.second = mLru.begin();
+      return entry.first;
+    }
+
+    void ReadRow(const size_t pDataRowIdx, std::vector<std::string>& pRow) const
+    {
+      if (pDataRowIdx >= mRowOffsets.size())
+      {
+        const std::string errStr = "requested row index " +
+          std::to_string(pDataRowIdx - GetDataRowIndex(0)) + " >= " +
+          std::to_string(GetRowCount()) + " (number of rows)";
+        throw std::out_of_range(errStr);
+      }
+
+      const uint64_t begin = GetRowOffset(pDataRowIdx);
+      const uint64_t end = (pDataRowIdx + 1 < mRowOffsets.size()) ? GetRowOffset(pDataRowIdx + 1) : mFileLength;
+      std::vector<char> buffer(static_cast<size_t>(end - begin));
+      mStream.seekg(static_cast<std::streamoff>(begin), std::ios::beg);
+      mStream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+      pRow.clear();
+      std::string cell;
+      bool quoted = false;
+      for (size_t i = 0; i < buffer.size(); ++i)
+      {
+        if (buffer[i] == mSeparatorParams.mQuoteChar)
         {
-          if (mSeparatorParams.mAutoQuote &&
-              ((itc->find(mSeparatorParams.mSeparator) != std::string::npos) ||
-               (itc->find(' ') != std::string::npos) ||
-               (itc->find('\n') != std::string::npos)))
+          if (cell.empty() || (cell[0] == mSeparatorParams.mQuoteChar))
           {
-            // escape quotes in string
-            std::string str = *itc;
-            const std::string quoteCharStr = std::string(1, mSeparatorParams.mQuoteChar);
-            ReplaceString(str, quoteCharStr, quoteCharStr + quoteCharStr);
-
-            pStream << quoteCharStr << str << quoteCharStr;
+            quoted = !quoted;
+          }
+          else if (mSeparatorParams.mTrim)
+          {
+            // allow whitespace before first mQuoteChar
+            const auto firstQuote = std::find(cell.begin(), cell.end(), mSeparatorParams.mQuoteChar);
+            if (std::all_of(cell.begin(), firstQuote, [](int ch) { return isspace(ch); }))
+            {
+              quoted = !quoted;
+            }
+          }
+          cell += buffer[i];
+        }
+        else if (buffer[i] == mSeparatorParams.mSeparator)
+        {
+          if (!quoted)
+          {
+            pRow.push_back(Unquote(Trim(cell)));
+            cell.clear();
           }
           else
           {
-            pStream << *itc;
+            cell += buffer[i];
           }
-
-          if (std::distance(itc, itr->end()) > 1)
+        }
+        else if ((buffer[i] == '\r') || (buffer[i] == '\n'))
+        {
+          if (mSeparatorParams.mQuotedLinebreaks && quoted)
           {
-            pStream << mSeparatorParams.mSeparator;
+            cell += buffer[i];
+          }
+          else if (buffer[i] == '\n')
+          {
+            break;
           }
         }
-        pStream << (mSeparatorParams.mHasCR ? "\r\n" : "\n");
+        else
+        {
+          cell += buffer[i];
+        }
       }
-    }
-
-    size_t GetDataRowCount() const
-    {
-      return mData.size();
-    }
-
-    size_t GetDataColumnCount() const
-    {
-      const size_t firstDataRow = static_cast<size_t>((mLabelParams.mColumnNameIdx >= 0) ? mLabelParams.mColumnNameIdx : 0);
-      return (mData.size() > firstDataRow) ? mData.at(firstDataRow).size() : 0;
+      pRow.push_back(Unquote(Trim(cell)));
     }
 
     inline size_t GetDataRowIndex(const size_t pRowIdx) const
@@ -1827,7 +3821,12 @@ namespace rapidcsv
 
         // unescape quotes in string
         const std::string quoteCharStr = std::string(1, mSeparatorParams.mQuoteChar);
-        ReplaceString(str, quoteCharStr + quoteCharStr, quoteCharStr);
+        size_t pos = 0;
+        while ((pos = str.find(quoteCharStr + quoteCharStr, pos)) != std::string::npos)
+        {
+          str.replace(pos, 2, quoteCharStr);
+          pos += 1;
+        }
 
         return str;
       }
@@ -1837,81 +3836,25 @@ namespace rapidcsv
       }
     }
 
-    void UpdateColumnNames()
-    {
-      mColumnNames.clear();
-      if ((mLabelParams.mColumnNameIdx >= 0) &&
-          (static_cast<int>(mData.size()) > mLabelParams.mColumnNameIdx))
-      {
-        size_t i = 0;
-        for (auto& columnName : mData[static_cast<size_t>(mLabelParams.mColumnNameIdx)])
-        {
-          mColumnNames[columnName] = i++;
-        }
-      }
-    }
-
-    void UpdateRowNames()
-    {
-      mRowNames.clear();
-      if ((mLabelParams.mRowNameIdx >= 0) &&
-          (static_cast<int>(mData.size()) >
-           (mLabelParams.mColumnNameIdx + 1)))
-      {
-        size_t i = 0;
-        for (auto& dataRow : mData)
-        {
-          if (static_cast<int>(dataRow.size()) > mLabelParams.mRowNameIdx)
-          {
-            mRowNames[dataRow[static_cast<size_t>(mLabelParams.mRowNameIdx)]] = i++;
-          }
-        }
-      }
-    }
-
-#ifdef HAS_CODECVT
-#if defined(_MSC_VER)
-#pragma warning (push)
-#pragma warning (disable: 4996)
-#endif
-    static std::string ToString(const std::wstring& pWStr)
-    {
-      return std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t>{ }.to_bytes(pWStr);
-    }
-
-    static std::wstring ToWString(const std::string& pStr)
-    {
-      return std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t>{ }.from_bytes(pStr);
-    }
-#if defined(_MSC_VER)
-#pragma warning (pop)
-#endif
-#endif
-
-    static void ReplaceString(std::string& pStr, const std::string& pSearch, const std::string& pReplace)
-    {
-      size_t pos = 0;
-
-      while ((pos = pStr.find(pSearch, pos)) != std::string::npos)
-      {
-        pStr.replace(pos, pSearch.size(), pReplace);
-        pos += pReplace.size();
-      }
-    }
-
   private:
+    static const size_t sIndexBlockRows = 64;
+    static constexpr char sIndexMagic[8] = { 'R', 'C', 'S', 'V', 'L', 'I', 'X', '1' };
+
     std::string mPath;
     LabelParams mLabelParams;
     SeparatorParams mSeparatorParams;
     ConverterParams mConverterParams;
     LineReaderParams mLineReaderParams;
-    std::vector<std::vector<std::string>> mData;
+    LazyParams mLazyParams;
+    mutable std::ifstream mStream;
+    uint64_t mFileLength = 0;
+    uint64_t mDataOffset = 0;
+    std::vector<uint64_t> mBlockOffsets;
+    std::vector<uint32_t> mRowOffsets;
+    size_t mFirstRowSize = 0;
+    std::vector<std::string> mColumnNameRow;
     std::map<std::string, size_t> mColumnNames;
-    std::map<std::string, size_t> mRowNames;
-#ifdef HAS_CODECVT
-    bool mIsUtf16 = false;
-    bool mIsLE = false;
-#endif
-    bool mHasUtf8BOM = false;
+    mutable std::list<size_t> mLru;
+    mutable std::unordered_map<size_t, std::pair<std::vector<std::string>, std::list<size_t>::iterator>> mCache;
   };
 }